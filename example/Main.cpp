@@ -19,33 +19,33 @@ int main(int argc, char *argv[])
         "FOREIGN KEY(testreal2) REFERENCES TestTable(testreal)"
         ");";
     db.rawExec(sql);
-    db.prepareStatement("testStatement", "INSERT INTO TestTable values (?, ?)");    //the following lines show the 'ugly' way of working with prepared statements
-    db.getStatement("testStatement")->bind(1, "A String");  //binding statements
-    db.getStatement("testStatement")->bind(2, 5.0);
-    db.getStatement("testStatement")->step();   //stepping the statement
-    db.getStatement("testStatement")->reset();  //resetting the statement to be ran again
+    StatementId insert = db.prepareStatement("testStatement", "INSERT INTO TestTable values (?, ?)");    //the following lines show the 'ugly' way of working with prepared statements
+    db.getStatement(insert)->bind(1, "A String");  //binding statements, looking the statement up by its handle skips the string search
+    db.getStatement(insert)->bind(2, 5.0);
+    db.getStatement("testStatement")->step();   //stepping the statement, statements can still be looked up by name
+    db.getStatement(insert)->reset();  //resetting the statement to be ran again
 
-    std::ifstream file("example/smile.png");    //opening a file into an ifstream
+    std::ifstream file("example/smile.png", std::ifstream::binary);    //opening a file into an ifstream
     file.seekg(0, std::ifstream::end);
     std::streampos size = file.tellg();
     file.seekg(0);
-    char *buffer = new char[size];  //relatively unsafe - can crash the program if file is null
-    file.read(buffer, size);
-    
-
 
     StatementHandler *stmt = db.prepareStatement("testStatement2", 
         "INSERT INTO TestTable2(testreal2, testblob) values (?, ?)");    //these lines show the 'clean' way of working with prepared statements
     stmt->setInputAlias("real", 1);    //giving the input columns aliases
     stmt->setInputAlias("blob", 2);
     stmt->bind("real", 5.0); //does the same as stmt->bind(1, 5.0) but is easier to interpret
-    stmt->bind("blob", buffer);
+    stmt->bindZeroBlob("blob", size > 0 ? (size_t)size : 0);   //making room for the file without reading it into memory
     stmt->step();
     stmt->reset();
     std::cout << db.changes() << " change(s)" << std::endl; // reporting the changed rows that the statement caused
-    
+
+    if (size > 0) {
+        std::unique_ptr<BlobStream> blob = db.openBlob("TestTable2", "testblob", db.lastInsertRowid(), true);
+        std::ostream out(blob.get());   //streaming the file into the blob a chunk at a time
+        out << file.rdbuf();
+    }
     file.close();   //file cleanup
-    delete buffer;
     
     
     db.prepareStatement("testStatement3",
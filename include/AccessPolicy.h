@@ -0,0 +1,249 @@
+/**
+ *  AccessPolicy.h
+ *  Provides column access whose type checking is chosen at compile time,
+ *  so hot loops can drop the check without changing the code reading them
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_ACCESSPOLICY_H
+#define SQLITER_ACCESSPOLICY_H
+
+#include <sqlite3.h>
+#include <string>
+#include "StatementHandler.h"
+#include "ColumnKey.h"
+#include "ColumnView.h"
+#include "StringRef.h"
+#include "SQLiteException.h"
+
+namespace SQLiter {
+
+    /**
+     *  Policy that checks the type of every column read and throws an
+     *  SQLiteException on a mismatch. StatementHandler's own getters read
+     *  through access<Checked>().
+     */
+    struct Checked {
+        static inline void expect(sqlite3_stmt *stmt, const int column, const int type,
+            const char *message) {
+            if (sqlite3_column_type(stmt, column) != type)
+                throw SQLiteException(message);
+        }
+    };
+
+    /**
+     *  Policy that never checks column types. Values are converted by SQLite
+     *  the way ValueHandler converts them, and the sqlite3_column_type call
+     *  made per read by Checked disappears.
+     */
+    struct Unchecked {
+        static inline void expect(sqlite3_stmt *, const int, const int, const char *) {}
+    };
+
+    /**
+     *  Policy that checks like Checked in debug builds and compiles to
+     *  Unchecked when NDEBUG is defined.
+     */
+    struct DebugChecked {
+        static inline void expect(sqlite3_stmt *stmt, const int column, const int type,
+            const char *message) {
+#ifndef NDEBUG
+            Checked::expect(stmt, column, type, message);
+#else
+            (void)stmt;
+            (void)column;
+            (void)type;
+            (void)message;
+#endif
+        }
+    };
+
+    /**
+     *  View of a StatementHandler's current row with the typed getters of
+     *  StatementHandler, checking column types as Policy says. Obtained
+     *  from StatementHandler::access or StatementHandler::unchecked and only
+     *  valid while the StatementHandler is.
+     *
+     *  Every getter is inline, so with Unchecked, or DebugChecked in a
+     *  release build, each read is a single sqlite3_column call. Text and
+     *  blobs are measured with sqlite3_column_bytes, and NULL reads as an
+     *  empty string.
+     *
+     *  Useage:     auto cols = stmt->access<DebugChecked>();
+     *              while (stmt->step())
+     *                  total += cols.getDouble(2);
+     *
+     *  @tparam Policy - Checked, Unchecked or DebugChecked
+     */
+    template <class Policy>
+    class ColumnAccess {
+    private:
+        StatementHandler *owner;
+        sqlite3_stmt *stmt;
+        const unsigned *generation;
+    public:
+
+        /**
+         *  Constructor used by StatementHandler::access.
+         *
+         *  @param statement - StatementHandler to read from
+         *  @param rowGeneration - Row counter of the statement, used by views
+         */
+        ColumnAccess(StatementHandler *statement, const unsigned *rowGeneration) :
+            owner(statement), stmt(statement->getHandle()), generation(rowGeneration) {};
+
+        /**
+         *  Returns the value of a text column.
+         *
+         *  @param column - Integer representing the column number to read
+         *
+         *  @return - Copy of the text
+         */
+        inline std::string getString(const int column) const {
+            Policy::expect(stmt, column, SQLITE_TEXT, "Column doesn't contain a string");
+            const char *text = (const char*)sqlite3_column_text(stmt, column);
+            if (text == nullptr)
+                return std::string();
+            return std::string(text, sqlite3_column_bytes(stmt, column));
+        }
+
+        /**
+         *  Returns the value of an integer column.
+         *
+         *  @param column - Integer representing the column number to read
+         *
+         *  @return - Value of the column
+         */
+        inline int getInt(const int column) const {
+            Policy::expect(stmt, column, SQLITE_INTEGER, "Column doesn't contain a int");
+            return sqlite3_column_int(stmt, column);
+        }
+
+        /**
+         *  Returns the value of an integer column as a 64 bit integer.
+         *
+         *  @param column - Integer representing the column number to read
+         *
+         *  @return - Value of the column
+         */
+        inline sqlite3_int64 getInt64(const int column) const {
+            Policy::expect(stmt, column, SQLITE_INTEGER, "Column doesn't contain a int");
+            return sqlite3_column_int64(stmt, column);
+        }
+
+        /**
+         *  Returns the value of a floating point column.
+         *
+         *  @param column - Integer representing the column number to read
+         *
+         *  @return - Value of the column
+         */
+        inline double getDouble(const int column) const {
+            Policy::expect(stmt, column, SQLITE_FLOAT, "Column doesn't contain a float");
+            return sqlite3_column_double(stmt, column);
+        }
+
+        /**
+         *  Returns a pointer to the value of a blob column.
+         *
+         *  @param column - Integer representing the column number to read
+         *
+         *  @return - Pointer to the blob, valid until the next step or reset
+         */
+        inline const void *getBlob(const int column) const {
+            Policy::expect(stmt, column, SQLITE_BLOB, "Column doesn't contain a blob");
+            return sqlite3_column_blob(stmt, column);
+        }
+
+        /**
+         *  Returns a view of the text in a column without copying it.
+         *
+         *  @param column - Integer representing the column number to read
+         *
+         *  @return - TextView of the text
+         */
+        inline TextView getStringView(const int column) const {
+            Policy::expect(stmt, column, SQLITE_TEXT, "Column doesn't contain a string");
+            const char *text = (const char*)sqlite3_column_text(stmt, column);
+            return TextView(text, sqlite3_column_bytes(stmt, column), generation);
+        }
+
+        /**
+         *  Returns a view of the blob in a column without copying it.
+         *
+         *  @param column - Integer representing the column number to read
+         *
+         *  @return - BlobView of the blob
+         */
+        inline BlobView getBytes(const int column) const {
+            Policy::expect(stmt, column, SQLITE_BLOB, "Column doesn't contain a blob");
+            const void *blob = sqlite3_column_blob(stmt, column);
+            return BlobView(blob, sqlite3_column_bytes(stmt, column), generation);
+        }
+
+        /**
+         *  Getters taking a column alias. See the getters taking an index.
+         */
+        inline std::string getString(const StringRef column) const {
+            return getString(owner->outputIndex(column));
+        }
+
+        inline int getInt(const StringRef column) const {
+            return getInt(owner->outputIndex(column));
+        }
+
+        inline sqlite3_int64 getInt64(const StringRef column) const {
+            return getInt64(owner->outputIndex(column));
+        }
+
+        inline double getDouble(const StringRef column) const {
+            return getDouble(owner->outputIndex(column));
+        }
+
+        inline const void *getBlob(const StringRef column) const {
+            return getBlob(owner->outputIndex(column));
+        }
+
+        inline TextView getStringView(const StringRef column) const {
+            return getStringView(owner->outputIndex(column));
+        }
+
+        inline BlobView getBytes(const StringRef column) const {
+            return getBytes(owner->outputIndex(column));
+        }
+
+        /**
+         *  Getters taking a ColumnKey. See the getters taking an index.
+         */
+        inline std::string getString(const ColumnKey column) const {
+            return getString(owner->outputIndex(column));
+        }
+
+        inline int getInt(const ColumnKey column) const {
+            return getInt(owner->outputIndex(column));
+        }
+
+        inline sqlite3_int64 getInt64(const ColumnKey column) const {
+            return getInt64(owner->outputIndex(column));
+        }
+
+        inline double getDouble(const ColumnKey column) const {
+            return getDouble(owner->outputIndex(column));
+        }
+
+        inline const void *getBlob(const ColumnKey column) const {
+            return getBlob(owner->outputIndex(column));
+        }
+
+        inline TextView getStringView(const ColumnKey column) const {
+            return getStringView(owner->outputIndex(column));
+        }
+
+        inline BlobView getBytes(const ColumnKey column) const {
+            return getBytes(owner->outputIndex(column));
+        }
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,141 @@
+/**
+ *  BlobStream.h
+ *  Provides incremental reading and writing of a single blob in the
+ *  database, without loading the whole blob into memory
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_BLOBSTREAM_H
+#define SQLITER_BLOBSTREAM_H
+
+#include <sqlite3.h>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "SQLiteException.h"
+
+namespace SQLiter {
+
+    /**
+     *  Handle to one blob in the database opened with sqlite3_blob_open.
+     *
+     *  The blob can be read and written in chunks at any offset with read()
+     *  and write(), or sequentially through std::istream and std::ostream,
+     *  as BlobStream is a std::streambuf holding a single fixed size buffer.
+     *  Either way memory use is bounded by the chunk size rather than the
+     *  size of the blob.
+     *
+     *  A blob cannot change size through a BlobStream. To store a new blob,
+     *  insert a zeroblob of the final size with
+     *  StatementHandler::bindZeroBlob and then write into it.
+     *
+     *  If the row holding the blob is changed or deleted the handle expires
+     *  and further reads and writes fail with SQLITE_ABORT. Every BlobStream
+     *  must be destroyed before its database is closed.
+     *
+     *  Useage:     auto blob = db.openBlob("images", "data", rowid, true);
+     *              std::ostream out(blob.get());
+     *              out << file.rdbuf();
+     */
+    class BlobStream : public std::streambuf {
+    private:
+        sqlite3 *db;
+        sqlite3_blob *blob;
+        int blobSize;
+        bool writable;
+
+        /**
+         *  Offset in the blob of the first byte of the buffer
+         */
+        int base;
+        std::vector<char> buffer;
+
+        BlobStream(const BlobStream &) = delete;
+        BlobStream &operator=(const BlobStream &) = delete;
+
+        /**
+         *  Returns the offset of the next byte to be read or written.
+         */
+        int position() const;
+
+        /**
+         *  Writes out whatever is in the put area and drops both areas,
+         *  leaving base at the current position.
+         *
+         *  @return - SQLite3 result code of the write
+         */
+        int flush();
+
+    protected:
+        int_type underflow() override;
+        int_type overflow(int_type c) override;
+        int sync() override;
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+            std::ios_base::openmode which) override;
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+    public:
+
+        /**
+         *  Constructor opens a blob.
+         *
+         *  @param connection - Database holding the blob
+         *  @param database - Name of the database, "main" unless attached
+         *  @param table - Table holding the blob
+         *  @param column - Column holding the blob
+         *  @param row - Rowid of the row holding the blob
+         *  @param write - Whether the blob is opened for writing
+         *  @param chunkSize - Size of the buffer used by the stream functions
+         *
+         *  @return - BlobStream positioned at the start of the blob
+         */
+        BlobStream(sqlite3 *connection, const std::string database, const std::string table,
+            const std::string column, const sqlite3_int64 row, const bool write,
+            const size_t chunkSize = 65536);
+
+        /**
+         *  Destructor writes out buffered data and closes the blob.
+         */
+        ~BlobStream();
+
+        /**
+         *  Gives the size of the blob.
+         *
+         *  @return - Size of the blob in bytes
+         */
+        inline int size() const {
+            return blobSize;
+        }
+
+        /**
+         *  Reads part of the blob. Does not use or move the stream position.
+         *
+         *  @param out - Buffer to read into, at least count bytes long
+         *  @param count - Number of bytes to read
+         *  @param offset - Offset in the blob to read from
+         */
+        void read(void *out, const int count, const int offset);
+
+        /**
+         *  Writes part of the blob. Does not use or move the stream position.
+         *  Writing past the end of the blob throws.
+         *
+         *  @param in - Bytes to write
+         *  @param count - Number of bytes to write
+         *  @param offset - Offset in the blob to write to
+         */
+        void write(const void *in, const int count, const int offset);
+
+        /**
+         *  Moves the handle to the same column of another row, which is
+         *  faster than opening a new BlobStream. The stream position returns
+         *  to the start of the blob.
+         *
+         *  @param row - Rowid of the row holding the blob
+         */
+        void reopen(const sqlite3_int64 row);
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,122 @@
+/**
+ *  Codec.h
+ *  Provides the trait used to bind and read C++ types, which users can
+ *  specialize for their own types
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_CODEC_H
+#define SQLITER_CODEC_H
+
+#include <sqlite3.h>
+#include <type_traits>
+#include <utility>
+#include "ColumnTraits.h"
+#include "StringRef.h"
+#if __cplusplus >= 201703L
+#include <optional>
+#endif
+
+namespace SQLiter {
+
+    /**
+     *  Describes how a C++ type is bound to a statement variable and read
+     *  back from a result column. Every bind template of StatementHandler,
+     *  ValueHandler::as, RowRange's Row::get, TypedStatement and
+     *  SQLiteHandler::insertMany go through Codec.
+     *
+     *  The types handled by ColumnTraits work out of the box. Specialize
+     *  Codec inside namespace SQLiter to add a type of your own, giving the
+     *  same two functions as ColumnTraits:
+     *
+     *      static int bind(sqlite3_stmt *stmt, const int var, const T &value);
+     *      static T read(sqlite3_stmt *stmt, const int column);
+     *
+     *  read is handed the statement itself, so a codec can decode straight
+     *  from the column's memory with sqlite3_column_blob or
+     *  sqlite3_column_text instead of going through an intermediate string.
+     *  The second template parameter is there for partial specializations
+     *  selected with std::enable_if.
+     *
+     *  To use the type as an argument or result of a function registered
+     *  with SQLiteHandler::scalarFunction, also give
+     *
+     *      static T read(sqlite3_value *value);
+     *      static void result(sqlite3_context *context, const T &value);
+     *
+     *  Useage:     namespace SQLiter {
+     *                  template <>
+     *                  struct Codec<Uuid> {
+     *                      static int bind(sqlite3_stmt *stmt, const int var, const Uuid &id) {
+     *                          return bindBlob(stmt, var, id.bytes, 16, SQLITE_TRANSIENT);
+     *                      }
+     *                      static Uuid read(sqlite3_stmt *stmt, const int column) {
+     *                          return Uuid((const unsigned char*)sqlite3_column_blob(stmt, column));
+     *                      }
+     *                  };
+     *              }
+     *
+     *              stmt->bind(1, id);
+     *              Uuid owner = stmt->getColumn(0).as<Uuid>();
+     */
+    template <class T, class Enable = void>
+    struct Codec : ColumnTraits<T> {};
+
+#if __cplusplus >= 201703L
+    /**
+     *  std::optional of any type with a Codec, with NULL standing for an
+     *  empty optional.
+     */
+    template <class T>
+    struct Codec<std::optional<T>> {
+        static inline int bind(sqlite3_stmt *stmt, const int var, const std::optional<T> &value) {
+            if (!value)
+                return sqlite3_bind_null(stmt, var);
+            return Codec<T>::bind(stmt, var, *value);
+        }
+        static inline std::optional<T> read(sqlite3_stmt *stmt, const int column) {
+            if (sqlite3_column_type(stmt, column) == SQLITE_NULL)
+                return std::nullopt;
+            return Codec<T>::read(stmt, column);
+        }
+        static inline std::optional<T> read(sqlite3_value *value) {
+            if (sqlite3_value_type(value) == SQLITE_NULL)
+                return std::nullopt;
+            return Codec<T>::read(value);
+        }
+        static inline void result(sqlite3_context *context, const std::optional<T> &value) {
+            if (!value)
+                sqlite3_result_null(context);
+            else
+                Codec<T>::result(context, *value);
+        }
+    };
+#endif
+
+    /**
+     *  Whether a type has a Codec able to bind it.
+     */
+    template <class T>
+    struct HasCodec {
+    private:
+        template <class U>
+        static auto check(int) -> decltype(Codec<U>::bind((sqlite3_stmt*)nullptr, 0,
+            std::declval<const U &>()), std::true_type());
+
+        template <class U>
+        static std::false_type check(...);
+    public:
+        static const bool value = decltype(check<T>(0))::value;
+    };
+
+    /**
+     *  Whether StatementHandler binds a type through its Codec. Strings and
+     *  pointers are left to the bind overloads written for them.
+     */
+    template <class T>
+    struct BindsThroughCodec : std::integral_constant<bool, HasCodec<T>::value &&
+        !std::is_pointer<T>::value && !std::is_convertible<const T &, StringRef>::value> {};
+}
+
+#endif
\ No newline at end of file
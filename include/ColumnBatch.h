@@ -0,0 +1,277 @@
+/**
+ *  ColumnBatch.h
+ *  Provides a block of result rows stored column by column in contiguous
+ *  typed arrays
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_COLUMNBATCH_H
+#define SQLITER_COLUMNBATCH_H
+
+#include <sqlite3.h>
+#include <string>
+#include <vector>
+#include "ColumnView.h"
+#include "StringRef.h"
+
+namespace SQLiter {
+
+    /**
+     *  Values of a single result column for every row of a ColumnBatch.
+     *
+     *  Each column has one storage type for the whole batch, taken from the
+     *  declared type of the column where it has a clear affinity and from the
+     *  first non null value otherwise. Values of other types are converted
+     *  with SQLite's own conversions.
+     *
+     *      SQLITE_INTEGER  - intData() holds size() values
+     *      SQLITE_FLOAT    - doubleData() holds size() values
+     *      SQLITE_TEXT and
+     *      SQLITE_BLOB     - row r occupies bytes [offsetData()[r], offsetData()[r + 1])
+     *                        of byteData(); offsetData() holds size() + 1 values
+     *      SQLITE_NULL     - every value in the batch is null
+     *
+     *  Null values are marked in the null bitmap, bit r % 8 of byte r / 8 is
+     *  set if row r is null, and stored as 0, 0.0 or an empty run of bytes.
+     */
+    class ColumnData {
+    private:
+        friend class ColumnBatch;
+
+        int type;
+        size_t rows;
+
+        /**
+         *  Rows the arrays are reserved for up front, maxRows clamped to
+         *  initialRows. The arrays grow past it as rows arrive, so a large
+         *  maxRows on a small result costs nothing.
+         */
+        size_t capacity;
+        static const size_t initialRows = 1024;
+        std::string name;
+        std::vector<sqlite3_int64> ints;
+        std::vector<double> doubles;
+        std::vector<size_t> offsets;
+        std::vector<unsigned char> bytes;
+        std::vector<unsigned char> nulls;
+
+        /**
+         *  Empties the column, keeping the memory its arrays already hold.
+         *
+         *  @param stmt - Statement the batch is read from
+         *  @param column - Integer representing the column
+         *  @param maxRows - Largest number of rows the batch will hold
+         */
+        void start(sqlite3_stmt *stmt, const int column, const size_t maxRows);
+
+        /**
+         *  Fixes the storage type of the column, filling in the rows read so
+         *  far, which were all null.
+         *
+         *  @param storage - SQLite3 type code to store values as
+         */
+        void setType(const int storage);
+
+        /**
+         *  Appends the value in the current row of the statement.
+         *
+         *  @param stmt - Statement that has just returned a row
+         *  @param column - Integer representing the column
+         */
+        void append(sqlite3_stmt *stmt, const int column);
+
+    public:
+
+        /**
+         *  Default constructor creates an empty column.
+         */
+        ColumnData() : type(SQLITE_NULL), rows(0), capacity(0) {};
+
+        /**
+         *  Gives the storage type of the column in this batch.
+         *
+         *  @return - SQLITE_INTEGER, SQLITE_FLOAT, SQLITE_TEXT, SQLITE_BLOB or
+         *      SQLITE_NULL if every value is null
+         */
+        inline int getType() const {
+            return type;
+        }
+
+        /**
+         *  Gives the name of the column.
+         *
+         *  @return - Name of the column as returned by sqlite3_column_name
+         */
+        inline const std::string &getName() const {
+            return name;
+        }
+
+        /**
+         *  Gives the number of values in the column.
+         *
+         *  @return - Number of rows
+         */
+        inline size_t size() const {
+            return rows;
+        }
+
+        /**
+         *  Returns whether a value is null.
+         *
+         *  @param row - Row to check
+         *
+         *  @return - True if the value is null
+         */
+        inline bool isNull(const size_t row) const {
+            return (nulls[row / 8] & (1 << (row % 8))) != 0;
+        }
+
+        /**
+         *  Returns the null bitmap, holding (size() + 7) / 8 bytes.
+         *
+         *  @return - Pointer to the first byte of the bitmap
+         */
+        inline const unsigned char *nullBitmap() const {
+            return nulls.data();
+        }
+
+        /**
+         *  Returns the values of an SQLITE_INTEGER column.
+         *
+         *  @return - Pointer to size() contiguous integers
+         */
+        inline const sqlite3_int64 *intData() const {
+            return ints.data();
+        }
+
+        /**
+         *  Returns the values of an SQLITE_FLOAT column.
+         *
+         *  @return - Pointer to size() contiguous doubles
+         */
+        inline const double *doubleData() const {
+            return doubles.data();
+        }
+
+        /**
+         *  Returns the offsets of the values of an SQLITE_TEXT or SQLITE_BLOB
+         *  column into byteData().
+         *
+         *  @return - Pointer to size() + 1 contiguous offsets
+         */
+        inline const size_t *offsetData() const {
+            return offsets.data();
+        }
+
+        /**
+         *  Returns the bytes of every value of an SQLITE_TEXT or SQLITE_BLOB
+         *  column, one after the other. Text is not null terminated.
+         *
+         *  @return - Pointer to the first byte
+         */
+        inline const unsigned char *byteData() const {
+            return bytes.data();
+        }
+
+        /**
+         *  Returns the text of a row of an SQLITE_TEXT column.
+         *
+         *  @param row - Row to read
+         *
+         *  @return - StringRef to the text, valid as long as the batch is not
+         *      refilled or destroyed
+         */
+        inline StringRef getText(const size_t row) const {
+            return StringRef((const char*)bytes.data() + offsets[row],
+                offsets[row + 1] - offsets[row]);
+        }
+
+        /**
+         *  Returns the bytes of a row of an SQLITE_BLOB column.
+         *
+         *  @param row - Row to read
+         *
+         *  @return - BlobView of the bytes, valid as long as the batch is not
+         *      refilled or destroyed
+         */
+        inline BlobView getBlob(const size_t row) const {
+            return BlobView(bytes.data() + offsets[row],
+                offsets[row + 1] - offsets[row], nullptr);
+        }
+    };
+
+    /**
+     *  Block of up to a fixed number of rows read from a statement, stored
+     *  column by column so aggregations can run over contiguous arrays.
+     *  Filled by StatementHandler::fetchColumnar. Refilling a batch reuses
+     *  the memory of its arrays.
+     *
+     *  Useage:     ColumnBatch batch;
+     *              while (stmt->fetchColumnar(batch, 4096) > 0) {
+     *                  const double *price = batch[2].doubleData();
+     *                  for (size_t i = 0; i < batch.rowCount(); i++)
+     *                      total += price[i];
+     *              }
+     */
+    class ColumnBatch {
+    private:
+        friend class StatementHandler;
+
+        size_t rows;
+        std::vector<ColumnData> columns;
+
+        /**
+         *  Empties the batch and sets it up for the columns of a statement.
+         *
+         *  @param stmt - Statement the batch is read from
+         *  @param maxRows - Largest number of rows the batch will hold
+         */
+        void start(sqlite3_stmt *stmt, const size_t maxRows);
+
+        /**
+         *  Appends the current row of the statement.
+         *
+         *  @param stmt - Statement that has just returned a row
+         */
+        void append(sqlite3_stmt *stmt);
+
+    public:
+
+        /**
+         *  Default constructor creates an empty batch.
+         */
+        ColumnBatch() : rows(0) {};
+
+        /**
+         *  Gives the number of rows in the batch.
+         *
+         *  @return - Number of rows
+         */
+        inline size_t rowCount() const {
+            return rows;
+        }
+
+        /**
+         *  Gives the number of columns in the batch.
+         *
+         *  @return - Number of columns
+         */
+        inline int columnCount() const {
+            return (int)columns.size();
+        }
+
+        /**
+         *  Gives access to a column.
+         *
+         *  @param column - Integer representing the column
+         *
+         *  @return - Values of the column
+         */
+        inline const ColumnData &operator[](const int column) const {
+            return columns[column];
+        }
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,113 @@
+/**
+ *  ColumnKey.h
+ *  Provides column and variable names hashed at compile time
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_COLUMNKEY_H
+#define SQLITER_COLUMNKEY_H
+
+#include <cstddef>
+#include <type_traits>
+#include "StringRef.h"
+
+namespace SQLiter {
+
+    /**
+     *  64 bit FNV-1a hash of a name, usable in constant expressions. Gives
+     *  the same result as StringRef::hash.
+     *
+     *  @param name - Pointer to the first character
+     *  @param len - Number of characters
+     *  @param h - Hash of the characters before name
+     *
+     *  @return - Hash of the name
+     */
+    constexpr unsigned long long hashName(const char *name, const size_t len,
+        const unsigned long long h = 14695981039346656037ULL) {
+        return len == 0 ? h :
+            hashName(name + 1, len - 1, (h ^ (unsigned char)name[0]) * 1099511628211ULL);
+    }
+
+    /**
+     *  Column or variable name together with its hash. StatementHandler
+     *  looks a ColumnKey up by comparing its hash against the hashes of the
+     *  statement's names, computed once when the statement was prepared, so
+     *  name based access inside a loop costs an integer search instead of
+     *  string comparisons.
+     *
+     *  Create keys with SQLITER_COL, which always hashes at compile time, or
+     *  the _col literal from SQLiter::literals.
+     *
+     *  Useage:     using namespace SQLiter::literals;
+     *              while (stmt->step())
+     *                  total += stmt->getDouble("price"_col);
+     *
+     *              stmt->bind(SQLITER_COL("min"), 10);
+     */
+    class ColumnKey {
+    private:
+        const char *ptr;
+        size_t len;
+        unsigned long long h;
+    public:
+
+        /**
+         *  Constructor hashes a name.
+         *
+         *  @param name - Pointer to the first character of the name
+         *  @param size - Number of characters
+         */
+        constexpr ColumnKey(const char *name, const size_t size) :
+            ptr(name), len(size), h(hashName(name, size)) {}
+
+        /**
+         *  Constructor takes a name and its precomputed hash.
+         *
+         *  @param name - Pointer to the first character of the name
+         *  @param size - Number of characters
+         *  @param hash - hashName(name, size)
+         */
+        constexpr ColumnKey(const char *name, const size_t size, const unsigned long long hash) :
+            ptr(name), len(size), h(hash) {}
+
+        /**
+         *  Returns the hash of the name.
+         *
+         *  @return - 64 bit FNV-1a hash
+         */
+        constexpr unsigned long long hash() const {
+            return h;
+        }
+
+        /**
+         *  Returns the name.
+         *
+         *  @return - StringRef to the name
+         */
+        inline StringRef name() const {
+            return StringRef(ptr, len);
+        }
+    };
+
+    namespace literals {
+
+        /**
+         *  Creates a ColumnKey from a string literal.
+         *
+         *  Useage:     stmt->getInt("id"_col);
+         */
+        constexpr ColumnKey operator"" _col(const char *name, const size_t size) {
+            return ColumnKey(name, size);
+        }
+    }
+}
+
+/**
+ *  Creates a ColumnKey from a string literal, hashing it at compile time.
+ */
+#define SQLITER_COL(name) ::SQLiter::ColumnKey(name, sizeof(name) - 1, \
+    std::integral_constant<unsigned long long, ::SQLiter::hashName(name, sizeof(name) - 1)>::value)
+
+#endif
\ No newline at end of file
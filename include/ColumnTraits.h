@@ -0,0 +1,331 @@
+/**
+ *  ColumnTraits.h
+ *  Provides compile time selection of the SQLite3 bind and column functions
+ *  for C++ types
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_COLUMNTRAITS_H
+#define SQLITER_COLUMNTRAITS_H
+
+#include <sqlite3.h>
+#include <climits>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "StringRef.h"
+#include "SQLiteException.h"
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+namespace SQLiter {
+
+    /**
+     *  Binds text of any length. Uses sqlite3_bind_text64 when built against
+     *  SQLite 3.8.7 or later, so lengths past 2GB are reported by SQLite as
+     *  SQLITE_TOOBIG instead of being truncated. Older versions throw.
+     *
+     *  @param stmt - Statement to bind to
+     *  @param var - Integer representing the variable to bind to
+     *  @param text - Pointer to the first character
+     *  @param size - Number of bytes
+     *  @param destructor - SQLITE_STATIC, SQLITE_TRANSIENT or a function
+     *      freeing the text
+     *
+     *  @return - SQLite3 result code
+     */
+    inline int bindText(sqlite3_stmt *stmt, const int var, const char *text, const size_t size,
+        const sqlite3_destructor_type destructor) {
+#if SQLITE_VERSION_NUMBER >= 3008007
+        return sqlite3_bind_text64(stmt, var, text, (sqlite3_uint64)size, destructor, SQLITE_UTF8);
+#else
+        if (size > (size_t)INT_MAX)
+            throw SQLiteException("Text Too Large To Bind");
+        return sqlite3_bind_text(stmt, var, text, (int)size, destructor);
+#endif
+    }
+
+    /**
+     *  Binds a blob of any length. See bindText.
+     *
+     *  @param stmt - Statement to bind to
+     *  @param var - Integer representing the variable to bind to
+     *  @param blob - Pointer to the first byte
+     *  @param size - Number of bytes
+     *  @param destructor - SQLITE_STATIC, SQLITE_TRANSIENT or a function
+     *      freeing the blob
+     *
+     *  @return - SQLite3 result code
+     */
+    inline int bindBlob(sqlite3_stmt *stmt, const int var, const void *blob, const size_t size,
+        const sqlite3_destructor_type destructor) {
+#if SQLITE_VERSION_NUMBER >= 3008007
+        return sqlite3_bind_blob64(stmt, var, blob, (sqlite3_uint64)size, destructor);
+#else
+        if (size > (size_t)INT_MAX)
+            throw SQLiteException("Blob Too Large To Bind");
+        return sqlite3_bind_blob(stmt, var, blob, (int)size, destructor);
+#endif
+    }
+
+    /**
+     *  Sets the result of an SQL function to text of any length. See
+     *  bindText.
+     *
+     *  @param context - Context of the function call
+     *  @param text - Pointer to the first character
+     *  @param size - Number of bytes
+     */
+    inline void resultText(sqlite3_context *context, const char *text, const size_t size) {
+#if SQLITE_VERSION_NUMBER >= 3008007
+        sqlite3_result_text64(context, text, (sqlite3_uint64)size, SQLITE_TRANSIENT, SQLITE_UTF8);
+#else
+        if (size > (size_t)INT_MAX)
+            throw SQLiteException("Text Too Large To Return");
+        sqlite3_result_text(context, text, (int)size, SQLITE_TRANSIENT);
+#endif
+    }
+
+    /**
+     *  Sets the result of an SQL function to a blob of any length. See
+     *  resultText.
+     *
+     *  @param context - Context of the function call
+     *  @param blob - Pointer to the first byte
+     *  @param size - Number of bytes
+     */
+    inline void resultBlob(sqlite3_context *context, const void *blob, const size_t size) {
+#if SQLITE_VERSION_NUMBER >= 3008007
+        sqlite3_result_blob64(context, blob, (sqlite3_uint64)size, SQLITE_TRANSIENT);
+#else
+        if (size > (size_t)INT_MAX)
+            throw SQLiteException("Blob Too Large To Return");
+        sqlite3_result_blob(context, blob, (int)size, SQLITE_TRANSIENT);
+#endif
+    }
+
+    /**
+     *  Traits describing how a C++ type is bound to a statement variable and
+     *  read back from a result column. Each specialization provides
+     *
+     *      static int bind(sqlite3_stmt *stmt, const int var, const T &value);
+     *      static T read(sqlite3_stmt *stmt, const int column);
+     *
+     *  and, for the arguments and results of SQL functions,
+     *
+     *      static T read(sqlite3_value *value);
+     *      static void result(sqlite3_context *context, const T &value);
+     *
+     *  bind returns the SQLite3 result code. read converts whatever is in the
+     *  column or value using SQLite's own conversions and does not check its
+     *  type first; that is left to callers which want it.
+     *
+     *  Text and blobs are bound as SQLITE_TRANSIENT, so the value only needs
+     *  to live until bind returns, and results are copied the same way.
+     *  StringRef and std::string_view read from a column are only valid until
+     *  the statement is next stepped or reset, and read from a value until
+     *  the function returns.
+     *
+     *  These are the built in types of Codec, which is what the rest of the
+     *  library uses and what users specialize for their own types.
+     */
+    template <class T, class Enable = void>
+    struct ColumnTraits {};
+
+    /**
+     *  bool, stored as the integer 0 or 1.
+     */
+    template <>
+    struct ColumnTraits<bool> {
+        static inline int bind(sqlite3_stmt *stmt, const int var, const bool value) {
+            return sqlite3_bind_int(stmt, var, value ? 1 : 0);
+        }
+        static inline bool read(sqlite3_stmt *stmt, const int column) {
+            return sqlite3_column_int(stmt, column) != 0;
+        }
+        static inline bool read(sqlite3_value *value) {
+            return sqlite3_value_int(value) != 0;
+        }
+        static inline void result(sqlite3_context *context, const bool value) {
+            sqlite3_result_int(context, value ? 1 : 0);
+        }
+    };
+
+    /**
+     *  Integers of every width, stored as 64 bit integers. Unsigned values
+     *  too large for a signed 64 bit integer throw rather than wrap.
+     */
+    template <class T>
+    struct ColumnTraits<T, typename std::enable_if<std::is_integral<T>::value &&
+        !std::is_same<T, bool>::value>::type> {
+        static inline int bind(sqlite3_stmt *stmt, const int var, const T value) {
+            return sqlite3_bind_int64(stmt, var, toInt64(value));
+        }
+        static inline T read(sqlite3_stmt *stmt, const int column) {
+            return (T)sqlite3_column_int64(stmt, column);
+        }
+        static inline T read(sqlite3_value *value) {
+            return (T)sqlite3_value_int64(value);
+        }
+        static inline void result(sqlite3_context *context, const T value) {
+            sqlite3_result_int64(context, toInt64(value));
+        }
+        static inline sqlite3_int64 toInt64(const T value) {
+            if (!std::is_signed<T>::value && sizeof(T) >= sizeof(sqlite3_int64) &&
+                (unsigned long long)value > (unsigned long long)LLONG_MAX)
+                throw SQLiteException("Integer Too Large For SQLite");
+            return (sqlite3_int64)value;
+        }
+    };
+
+    /**
+     *  float and double, stored as doubles.
+     */
+    template <class T>
+    struct ColumnTraits<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+        static inline int bind(sqlite3_stmt *stmt, const int var, const T value) {
+            return sqlite3_bind_double(stmt, var, (double)value);
+        }
+        static inline T read(sqlite3_stmt *stmt, const int column) {
+            return (T)sqlite3_column_double(stmt, column);
+        }
+        static inline T read(sqlite3_value *value) {
+            return (T)sqlite3_value_double(value);
+        }
+        static inline void result(sqlite3_context *context, const T value) {
+            sqlite3_result_double(context, (double)value);
+        }
+    };
+
+    /**
+     *  std::string, copied in and out of the statement.
+     */
+    template <>
+    struct ColumnTraits<std::string> {
+        static inline int bind(sqlite3_stmt *stmt, const int var, const std::string &value) {
+            return bindText(stmt, var, value.data(), value.size(), SQLITE_TRANSIENT);
+        }
+        static inline std::string read(sqlite3_stmt *stmt, const int column) {
+            const char *text = (const char*)sqlite3_column_text(stmt, column);
+            if (text == nullptr)
+                return std::string();
+            return std::string(text, sqlite3_column_bytes(stmt, column));
+        }
+        static inline std::string read(sqlite3_value *value) {
+            const char *text = (const char*)sqlite3_value_text(value);
+            if (text == nullptr)
+                return std::string();
+            return std::string(text, sqlite3_value_bytes(value));
+        }
+        static inline void result(sqlite3_context *context, const std::string &value) {
+            resultText(context, value.data(), value.size());
+        }
+    };
+
+    /**
+     *  StringRef, read without copying out of the statement.
+     */
+    template <>
+    struct ColumnTraits<StringRef> {
+        static inline int bind(sqlite3_stmt *stmt, const int var, const StringRef value) {
+            return bindText(stmt, var, value.data(), value.size(), SQLITE_TRANSIENT);
+        }
+        static inline StringRef read(sqlite3_stmt *stmt, const int column) {
+            const char *text = (const char*)sqlite3_column_text(stmt, column);
+            if (text == nullptr)
+                return StringRef();
+            return StringRef(text, sqlite3_column_bytes(stmt, column));
+        }
+        static inline StringRef read(sqlite3_value *value) {
+            const char *text = (const char*)sqlite3_value_text(value);
+            if (text == nullptr)
+                return StringRef();
+            return StringRef(text, sqlite3_value_bytes(value));
+        }
+        static inline void result(sqlite3_context *context, const StringRef value) {
+            resultText(context, value.data(), value.size());
+        }
+    };
+
+    /**
+     *  Null terminated C strings. A NULL column reads as nullptr.
+     */
+    template <>
+    struct ColumnTraits<const char *> {
+        static inline int bind(sqlite3_stmt *stmt, const int var, const char *value) {
+            return sqlite3_bind_text(stmt, var, value, -1, SQLITE_TRANSIENT);
+        }
+        static inline const char *read(sqlite3_stmt *stmt, const int column) {
+            return (const char*)sqlite3_column_text(stmt, column);
+        }
+        static inline const char *read(sqlite3_value *value) {
+            return (const char*)sqlite3_value_text(value);
+        }
+        static inline void result(sqlite3_context *context, const char *value) {
+            if (value == nullptr)
+                sqlite3_result_null(context);
+            else
+                sqlite3_result_text(context, value, -1, SQLITE_TRANSIENT);
+        }
+    };
+
+    /**
+     *  Blobs held in a std::vector<unsigned char>, copied in and out of the
+     *  statement.
+     */
+    template <>
+    struct ColumnTraits<std::vector<unsigned char>> {
+        static inline int bind(sqlite3_stmt *stmt, const int var,
+            const std::vector<unsigned char> &value) {
+            if (value.empty())
+                return sqlite3_bind_zeroblob(stmt, var, 0);
+            return bindBlob(stmt, var, value.data(), value.size(), SQLITE_TRANSIENT);
+        }
+        static inline std::vector<unsigned char> read(sqlite3_stmt *stmt, const int column) {
+            const unsigned char *blob = (const unsigned char*)sqlite3_column_blob(stmt, column);
+            return std::vector<unsigned char>(blob, blob + sqlite3_column_bytes(stmt, column));
+        }
+        static inline std::vector<unsigned char> read(sqlite3_value *value) {
+            const unsigned char *blob = (const unsigned char*)sqlite3_value_blob(value);
+            return std::vector<unsigned char>(blob, blob + sqlite3_value_bytes(value));
+        }
+        static inline void result(sqlite3_context *context, const std::vector<unsigned char> &value) {
+            if (value.empty())
+                sqlite3_result_zeroblob(context, 0);
+            else
+                resultBlob(context, value.data(), value.size());
+        }
+    };
+
+#if __cplusplus >= 201703L
+    /**
+     *  std::string_view, read without copying out of the statement.
+     */
+    template <>
+    struct ColumnTraits<std::string_view> {
+        static inline int bind(sqlite3_stmt *stmt, const int var, const std::string_view value) {
+            return bindText(stmt, var, value.data(), value.size(), SQLITE_TRANSIENT);
+        }
+        static inline std::string_view read(sqlite3_stmt *stmt, const int column) {
+            const char *text = (const char*)sqlite3_column_text(stmt, column);
+            if (text == nullptr)
+                return std::string_view();
+            return std::string_view(text, sqlite3_column_bytes(stmt, column));
+        }
+        static inline std::string_view read(sqlite3_value *value) {
+            const char *text = (const char*)sqlite3_value_text(value);
+            if (text == nullptr)
+                return std::string_view();
+            return std::string_view(text, sqlite3_value_bytes(value));
+        }
+        static inline void result(sqlite3_context *context, const std::string_view value) {
+            resultText(context, value.data(), value.size());
+        }
+    };
+
+#endif
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,216 @@
+/**
+ *  ColumnView.h
+ *  Provides non-owning views of the text and blob values of a result column
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_COLUMNVIEW_H
+#define SQLITER_COLUMNVIEW_H
+
+#include <cassert>
+#include <string>
+#include "StringRef.h"
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+namespace SQLiter {
+
+    /**
+     *  Non-owning view of the text in a result column, returned by
+     *  StatementHandler::getStringView. The characters belong to SQLite and
+     *  are only valid until the statement is next stepped or reset.
+     *
+     *  The view remembers which row it was taken from and, in debug builds
+     *  (NDEBUG not defined), asserts if it is read after the statement has
+     *  moved on. The layout is the same in every build so that code built
+     *  with and without NDEBUG can share views.
+     */
+    class TextView {
+    private:
+        const char *ptr;
+        size_t len;
+        const unsigned *generation;
+        unsigned expected;
+
+        inline void check() const {
+            assert((generation == nullptr || *generation == expected)
+                && "TextView used after the statement was stepped or reset");
+        }
+
+    public:
+
+        /**
+         *  Default constructor creates an empty view.
+         */
+        TextView() : ptr(""), len(0),
+            generation(nullptr), expected(0) {};
+
+        /**
+         *  Constructor used by StatementHandler.
+         *
+         *  @param text - Pointer to the text of the column
+         *  @param size - Size of the text in bytes
+         *  @param gen - Row counter of the statement, nullptr if the value
+         *      does not belong to a statement
+         */
+        TextView(const char *text, const size_t size, const unsigned *gen) :
+            ptr(text != nullptr ? text : ""), len(size),
+            generation(gen), expected(gen != nullptr ? *gen : 0) {};
+
+        /**
+         *  Returns a pointer to the first character. SQLite null terminates
+         *  column text, so the pointer may also be used as a C string.
+         *
+         *  @return - Pointer to the characters
+         */
+        inline const char *data() const {
+            check();
+            return ptr;
+        }
+
+        /**
+         *  Returns the size of the text in bytes.
+         *
+         *  @return - Size in bytes
+         */
+        inline size_t size() const {
+            check();
+            return len;
+        }
+
+        /**
+         *  Returns whether the text is empty.
+         *
+         *  @return - True if the text is empty
+         */
+        inline bool empty() const {
+            return size() == 0;
+        }
+
+        inline const char *begin() const {
+            return data();
+        }
+
+        inline const char *end() const {
+            return data() + len;
+        }
+
+        inline char operator[](const size_t i) const {
+            return data()[i];
+        }
+
+        /**
+         *  Copies the text into a std::string, which stays valid after the
+         *  statement moves on.
+         *
+         *  @return - std::string holding a copy of the text
+         */
+        inline std::string str() const {
+            return std::string(data(), len);
+        }
+
+        /**
+         *  Converts the view to a StringRef, for example to bind the text to
+         *  another statement.
+         */
+        inline operator StringRef() const {
+            return StringRef(data(), len);
+        }
+
+#if __cplusplus >= 201703L
+        /**
+         *  Converts the view to a std::string_view.
+         */
+        inline operator std::string_view() const {
+            return std::string_view(data(), len);
+        }
+#endif
+    };
+
+    /**
+     *  Non-owning view of the bytes of a blob in a result column, returned by
+     *  StatementHandler::getBytes. The bytes belong to SQLite and are only
+     *  valid until the statement is next stepped or reset.
+     *
+     *  The view remembers which row it was taken from and, in debug builds
+     *  (NDEBUG not defined), asserts if it is read after the statement has
+     *  moved on. The layout is the same in every build.
+     */
+    class BlobView {
+    private:
+        const unsigned char *ptr;
+        size_t len;
+        const unsigned *generation;
+        unsigned expected;
+
+        inline void check() const {
+            assert((generation == nullptr || *generation == expected)
+                && "BlobView used after the statement was stepped or reset");
+        }
+
+    public:
+
+        /**
+         *  Default constructor creates an empty view.
+         */
+        BlobView() : ptr(nullptr), len(0),
+            generation(nullptr), expected(0) {};
+
+        /**
+         *  Constructor used by StatementHandler.
+         *
+         *  @param bytes - Pointer to the blob of the column
+         *  @param size - Size of the blob in bytes
+         *  @param gen - Row counter of the statement, nullptr if the value
+         *      does not belong to a statement
+         */
+        BlobView(const void *bytes, const size_t size, const unsigned *gen) :
+            ptr((const unsigned char *)bytes), len(size),
+            generation(gen), expected(gen != nullptr ? *gen : 0) {};
+
+        /**
+         *  Returns a pointer to the first byte, nullptr for an empty blob.
+         *
+         *  @return - Pointer to the bytes
+         */
+        inline const unsigned char *data() const {
+            check();
+            return ptr;
+        }
+
+        /**
+         *  Returns the size of the blob in bytes.
+         *
+         *  @return - Size in bytes
+         */
+        inline size_t size() const {
+            check();
+            return len;
+        }
+
+        /**
+         *  Returns whether the blob is empty.
+         *
+         *  @return - True if the blob is empty
+         */
+        inline bool empty() const {
+            return size() == 0;
+        }
+
+        inline const unsigned char *begin() const {
+            return data();
+        }
+
+        inline const unsigned char *end() const {
+            return data() + len;
+        }
+
+        inline unsigned char operator[](const size_t i) const {
+            return data()[i];
+        }
+    };
+}
+
+#endif
\ No newline at end of file
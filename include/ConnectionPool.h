@@ -0,0 +1,280 @@
+/**
+ *  ConnectionPool.h
+ *  Provides a pool of SQLiteHandler connections to a single database file,
+ *  split into a set of readers and a single writer
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_CONNECTIONPOOL_H
+#define SQLITER_CONNECTIONPOOL_H
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include "SQLiteHandler.h"
+
+namespace SQLiter {
+
+    /**
+     *  Class that opens a number of read connections and one write connection
+     *  to the same database file and hands them out to threads as leases.
+     *
+     *  By default the database is switched to WAL journaling so that readers
+     *  never block the writer and the writer never blocks readers. The change
+     *  is stored in the database file and outlives the pool. Every pooled
+     *  connection is its own SQLiteHandler and so has its own set of prepared
+     *  statements, which means a leased connection can be used freely by the
+     *  thread holding the lease without any further locking.
+     */
+    class ConnectionPool {
+    public:
+
+        /**
+         *  RAII handle to a pooled connection. The connection is returned to
+         *  the pool when the lease is destroyed. Leases can be moved but not
+         *  copied.
+         */
+        class Lease {
+        private:
+            ConnectionPool *pool;
+            SQLiteHandler *handler;
+            bool writer;
+        public:
+
+            /**
+             *  Constructor used by the pool to hand out a connection.
+             *
+             *  @param owner - Pool the connection belongs to
+             *  @param connection - The leased connection
+             *  @param isWriter - Whether the connection is the write connection
+             *
+             *  @return - Lease managing the connection
+             */
+            Lease(ConnectionPool *owner, SQLiteHandler *connection, const bool isWriter) :
+                pool(owner), handler(connection), writer(isWriter) {};
+
+            /**
+             *  Destructor returns the connection to the pool.
+             */
+            ~Lease();
+
+            /**
+             *  Explicitely deletes the copy constructor as only one thread may
+             *  hold a connection at a time.
+             */
+            Lease(Lease const &) = delete;
+
+            /**
+             *  Explicitely deletes the copy assignment operator as only one
+             *  thread may hold a connection at a time.
+             */
+            Lease &operator=(Lease const &) = delete;
+
+            /**
+             *  Move constructor takes over the connection of another lease.
+             */
+            Lease(Lease &&o);
+
+            /**
+             *  Move assignment operator returns the currently held connection
+             *  and takes over the connection of another lease.
+             */
+            Lease &operator=(Lease &&o);
+
+            /**
+             *  Returns the connection held by the lease.
+             *
+             *  @return - Pointer to the leased SQLiteHandler
+             */
+            inline SQLiteHandler *get() const {
+                return handler;
+            }
+
+            /**
+             *  Allows the lease to be used like a pointer to the connection.
+             *
+             *  @return - Pointer to the leased SQLiteHandler
+             */
+            inline SQLiteHandler *operator->() const {
+                return handler;
+            }
+
+            /**
+             *  Allows the lease to be used like a pointer to the connection.
+             *
+             *  @return - Reference to the leased SQLiteHandler
+             */
+            inline SQLiteHandler &operator*() const {
+                return *handler;
+            }
+
+            /**
+             *  Returns the connection to the pool before the lease is
+             *  destroyed.
+             */
+            void release();
+        };
+
+        /**
+         *  Constructor opens the database file at the given location once for
+         *  writing and the given number of times for reading. The file is
+         *  created if it does not exist and, unless useWal is false, switched
+         *  to WAL journaling permanently.
+         *
+         *  @param location - Location on disk of the database file
+         *  @param numReaders - Number of read connections to open, at least 1
+         *  @param busyMs - Milliseconds each connection waits on a locked
+         *      database before failing with SQLITE_BUSY
+         *  @param useWal - Whether to switch the database to WAL journaling
+         *
+         *  @return - ConnectionPool managing the opened connections
+         */
+        ConnectionPool(const std::string location, const unsigned numReaders,
+            const int busyMs = 5000, const bool useWal = true);
+
+        /**
+         *  Destructor closes every connection. All leases must have been
+         *  returned before the pool is destroyed.
+         */
+        ~ConnectionPool();
+
+        /**
+         *  Explicitely deletes the copy constructor as the pool owns its
+         *  connections.
+         */
+        ConnectionPool(ConnectionPool const &) = delete;
+
+        /**
+         *  Explicitely deletes the copy assignment operator as the pool owns
+         *  its connections.
+         */
+        ConnectionPool &operator=(ConnectionPool const &) = delete;
+
+        /**
+         *  Leases a read connection, blocking until one is free.
+         *
+         *  @return - Lease holding a read connection
+         */
+        Lease reader();
+
+        /**
+         *  Leases the write connection, blocking until it is free.
+         *
+         *  @return - Lease holding the write connection
+         */
+        Lease writer();
+
+        /**
+         *  Prepares a statement under the given key on every connection in the
+         *  pool, so it can later be fetched with getStatement(key) from any
+         *  lease. Blocks until every connection is free, so it must not be
+         *  called while the calling thread holds a lease.
+         *
+         *  @param key - Key to use to reference prepared statement
+         *  @param stmtStr - String to use to build the prepared statement with
+         */
+        void prepareStatement(const StringRef key, const StringRef stmtStr);
+
+        /**
+         *  Registers a statement under the given key on every connection in
+         *  the pool without preparing it, see SQLiteHandler::registerStatement.
+         *  Each connection prepares it when it is first used there, or during
+         *  warmUp. Blocks until every connection is free, so it must not be
+         *  called while the calling thread holds a lease.
+         *
+         *  @param key - Key to use to reference the statement
+         *  @param stmtStr - SQL of the statement
+         */
+        void registerStatement(const StringRef key, const StringRef stmtStr);
+
+        /**
+         *  Registers every statement of a manifest file on every connection in
+         *  the pool, see SQLiteHandler::loadManifest. The file is read once.
+         *  Blocks until every connection is free.
+         *
+         *  @param location - Location on disk of the manifest
+         *
+         *  @return - Number of statements in the manifest
+         */
+        size_t loadManifest(const std::string location);
+
+        /**
+         *  Prepares the registered statements of every connection in the
+         *  background, one thread per connection. Each connection is leased
+         *  only while its own statements are prepared, so the pool stays
+         *  usable and a connection leased early simply prepares statements as
+         *  they are used. The pool must outlive the returned future.
+         *
+         *  Useage:     pool.loadManifest("statements.sql");
+         *              std::future<void> warm = pool.warmUp();
+         *
+         *  @return - Future that becomes ready once every connection is done,
+         *      holding the first exception thrown if any
+         */
+        std::future<void> warmUp();
+
+        /**
+         *  Returns the number of read connections in the pool.
+         *
+         *  @return - Number of read connections
+         */
+        inline unsigned readerCount() const {
+            return (unsigned)readers.size();
+        }
+
+        /**
+         *  Returns the location of the database file the pool is connected to.
+         *
+         *  @return - Location on disk of the database file
+         */
+        inline const std::string &location() const {
+            return path;
+        }
+
+    private:
+        std::string path;
+        std::vector<std::unique_ptr<SQLiteHandler>> readers;
+        std::unique_ptr<SQLiteHandler> writeConn;
+
+        /**
+         *  Read connections that are not currently leased
+         */
+        std::vector<SQLiteHandler *> idleReaders;
+        bool writerBusy;
+
+        std::mutex lock;
+        std::condition_variable available;
+
+        /**
+         *  Returns a connection to the pool and wakes a waiting thread.
+         *
+         *  @param connection - Connection to return
+         *  @param isWriter - Whether the connection is the write connection
+         */
+        void giveBack(SQLiteHandler *connection, const bool isWriter);
+
+        /**
+         *  Leases one particular connection, blocking until it is free.
+         *
+         *  @param connection - Reader or writer of this pool
+         *
+         *  @return - Lease holding that connection
+         */
+        Lease lease(SQLiteHandler *connection);
+
+        /**
+         *  Runs a task on every connection in the pool once every connection
+         *  is free, holding all of them while it runs.
+         *
+         *  @param task - Function called with each connection in turn
+         */
+        void forEachConnection(const std::function<void(SQLiteHandler &)> &task);
+    };
+}
+
+#endif
\ No newline at end of file
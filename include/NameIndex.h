@@ -0,0 +1,216 @@
+/**
+ *  NameIndex.h
+ *  Provides a flat, sorted map from names to values that can be searched
+ *  without building a std::string
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_NAMEINDEX_H
+#define SQLITER_NAMEINDEX_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "ColumnKey.h"
+#include "StringRef.h"
+
+namespace SQLiter {
+
+    /**
+     *  Map from names to values stored as a vector of pairs sorted by name.
+     *
+     *  Lookups are a binary search over contiguous memory and take a
+     *  StringRef, so a C string or any other character buffer can be looked
+     *  up without first being copied into a std::string. Inserting is linear,
+     *  which suits names that are set up once and looked up often.
+     *
+     *  A second array, sorted by the hash of each name, lets a ColumnKey be
+     *  looked up by comparing integers. Names whose hashes collide are
+     *  marked so their lookups fall back to comparing the names.
+     */
+    template <class T>
+    class NameIndex {
+    private:
+        typedef std::pair<std::string, T> Entry;
+        std::vector<Entry> entries;
+
+        struct HashEntry {
+            unsigned long long hash;
+            T value;
+            bool unique;
+        };
+        std::vector<HashEntry> hashes;
+
+        /**
+         *  Returns the first hash entry whose hash is not less than the key.
+         */
+        inline typename std::vector<HashEntry>::const_iterator hashBound(
+            const unsigned long long hash) const {
+            size_t first = 0;
+            size_t count = hashes.size();
+            while (count > 0) {
+                const size_t step = count / 2;
+                if (hashes[first + step].hash < hash) {
+                    first += step + 1;
+                    count -= step + 1;
+                } else {
+                    count = step;
+                }
+            }
+            return hashes.begin() + first;
+        }
+
+        /**
+         *  Adds a name's hash to the hash array.
+         */
+        void insertHash(const unsigned long long hash, const T &value) {
+            auto pos = hashBound(hash);
+            if (pos != hashes.end() && pos->hash == hash) {
+                hashes[pos - hashes.begin()].unique = false;
+                return;
+            }
+            HashEntry entry = { hash, value, true };
+            hashes.insert(hashes.begin() + (pos - hashes.begin()), entry);
+        }
+
+        /**
+         *  Compares a stored name against a character buffer, ordering them
+         *  the same way std::string::compare does.
+         */
+        static inline int compare(const std::string &name, const char *key, const size_t len) {
+            return name.compare(0, name.size(), key, len);
+        }
+
+        /**
+         *  Returns the first entry whose name is not less than the key.
+         */
+        inline typename std::vector<Entry>::const_iterator lowerBound(const char *key,
+            const size_t len) const {
+            size_t first = 0;
+            size_t count = entries.size();
+            while (count > 0) {
+                const size_t step = count / 2;
+                if (compare(entries[first + step].first, key, len) < 0) {
+                    first += step + 1;
+                    count -= step + 1;
+                } else {
+                    count = step;
+                }
+            }
+            return entries.begin() + first;
+        }
+
+    public:
+
+        /**
+         *  Adds a name to the index. An existing entry with the same name is
+         *  left untouched.
+         *
+         *  @param key - Name to add
+         *  @param value - Value to store under the name
+         *
+         *  @return - True if the name was added, false if it already existed
+         */
+        bool insert(const StringRef key, const T &value) {
+            auto pos = lowerBound(key.data(), key.size());
+            if (pos != entries.end() && compare(pos->first, key.data(), key.size()) == 0)
+                return false;
+            entries.insert(entries.begin() + (pos - entries.begin()), Entry(key.str(), value));
+            insertHash(key.hash(), value);
+            return true;
+        }
+
+        /**
+         *  Adds a name to the index, replacing the value of an existing entry
+         *  with the same name.
+         *
+         *  @param key - Name to add or replace
+         *  @param value - Value to store under the name
+         */
+        void assign(const StringRef key, const T &value) {
+            auto pos = lowerBound(key.data(), key.size());
+            if (pos == entries.end() || compare(pos->first, key.data(), key.size()) != 0) {
+                entries.insert(entries.begin() + (pos - entries.begin()), Entry(key.str(), value));
+                insertHash(key.hash(), value);
+                return;
+            }
+            entries[pos - entries.begin()].second = value;
+            // names sharing a hash are looked up by name, so only a unique
+            // hash entry holds a copy of the value
+            auto hashPos = hashBound(key.hash());
+            if (hashPos->unique)
+                hashes[hashPos - hashes.begin()].value = value;
+        }
+
+        /**
+         *  Looks up a name. Searching does not allocate.
+         *
+         *  @param key - Name to look up
+         *
+         *  @return - Pointer to the stored value or nullptr if the name is
+         *      not in the index
+         */
+        inline const T *find(const StringRef key) const {
+            auto pos = lowerBound(key.data(), key.size());
+            if (pos != entries.end() && compare(pos->first, key.data(), key.size()) == 0)
+                return &pos->second;
+            return nullptr;
+        }
+
+        /**
+         *  Looks up a name by its hash, only comparing the name itself if
+         *  another name in the index shares its hash.
+         *
+         *  @param key - Name and hash to look up
+         *
+         *  @return - Pointer to the stored value or nullptr if the name is
+         *      not in the index
+         */
+        inline const T *find(const ColumnKey key) const {
+            auto pos = hashBound(key.hash());
+            if (pos == hashes.end() || pos->hash != key.hash())
+                return nullptr;
+            if (pos->unique)
+                return &pos->value;
+            return find(key.name());
+        }
+
+        /**
+         *  Removes a name from the index.
+         *
+         *  @param key - Name to remove
+         *
+         *  @return - True if the name was removed, false if it did not exist
+         */
+        bool erase(const StringRef key) {
+            auto pos = lowerBound(key.data(), key.size());
+            if (pos == entries.end() || compare(pos->first, key.data(), key.size()) != 0)
+                return false;
+            entries.erase(entries.begin() + (pos - entries.begin()));
+            hashes.clear();
+            for (size_t i = 0; i < entries.size(); i++)
+                insertHash(StringRef(entries[i].first).hash(), entries[i].second);
+            return true;
+        }
+
+        /**
+         *  Removes every name from the index.
+         */
+        inline void clear() {
+            entries.clear();
+            hashes.clear();
+        }
+
+        /**
+         *  Returns the number of names in the index.
+         *
+         *  @return - Number of names
+         */
+        inline size_t size() const {
+            return entries.size();
+        }
+    };
+}
+
+#endif
\ No newline at end of file
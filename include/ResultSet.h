@@ -0,0 +1,200 @@
+/**
+ *  ResultSet.h
+ *  Provides an owning copy of the full result of a statement, which can
+ *  outlive the statement and be handed between threads
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_RESULTSET_H
+#define SQLITER_RESULTSET_H
+
+#include <sqlite3.h>
+#include <string>
+#include <vector>
+#include "StatementHandler.h"
+#include "SQLiteException.h"
+
+namespace SQLiter {
+
+    /**
+     *  Owning copy of a single SQLite3 value of any storage class.
+     */
+    class ResultValue {
+    private:
+        int type;
+        sqlite3_int64 integer;
+        double real;
+        std::string bytes;
+    public:
+
+        /**
+         *  Default constructor creates a null value.
+         */
+        ResultValue() : type(SQLITE_NULL), integer(0), real(0.0) {};
+
+        /**
+         *  Constructor copies the value currently in a column of a statement.
+         *
+         *  @param stmt - Statement that has just returned a row
+         *  @param column - Integer representing the column to copy
+         *
+         *  @return - ResultValue holding a copy of the column's value
+         */
+        ResultValue(StatementHandler &stmt, const int column);
+
+        /**
+         *  Gives the storage class of the value.
+         *
+         *  @return - Integer containing the corresponding SQLite3 datatype code
+         *      Possible results: 1 - INT, 2 - FLOAT, 3 - TEXT, 4 - BLOB, 5 - NULL
+         */
+        inline int getType() const {
+            return type;
+        }
+
+        /**
+         *  Returns whether the value is null.
+         *
+         *  @return - True if the value is null
+         */
+        inline bool isNull() const {
+            return type == SQLITE_NULL;
+        }
+
+        /**
+         *  Returns the size of a text or blob value, in bytes.
+         *
+         *  @return - Size of the value in bytes, 0 for other types
+         */
+        inline int getSize() const {
+            return (int)bytes.size();
+        }
+
+        /**
+         *  Returns the value as an integer.
+         *
+         *  @return - Integer value
+         */
+        inline int getInt() const {
+            if (type == SQLITE_INTEGER)
+                return (int)integer;
+            throw SQLiteException("Value isn't an int");
+        }
+
+        /**
+         *  Returns the value as an SQLite3 int64.
+         *
+         *  @return - sqlite3_int64 value
+         */
+        inline sqlite3_int64 getInt64() const {
+            if (type == SQLITE_INTEGER)
+                return integer;
+            throw SQLiteException("Value isn't an int");
+        }
+
+        /**
+         *  Returns the value as a double precision float.
+         *
+         *  @return - Double value
+         */
+        inline double getDouble() const {
+            if (type == SQLITE_FLOAT)
+                return real;
+            throw SQLiteException("Value isn't a float");
+        }
+
+        /**
+         *  Returns the value as a string.
+         *
+         *  @return - Reference to the string held by the value
+         */
+        inline const std::string &getString() const {
+            if (type == SQLITE_TEXT)
+                return bytes;
+            throw SQLiteException("Value isn't a string");
+        }
+
+        /**
+         *  Returns the value as a blob, whose size is given by getSize().
+         *
+         *  @return - Pointer to the blob held by the value
+         */
+        inline const void *getBlob() const {
+            if (type == SQLITE_BLOB)
+                return bytes.data();
+            throw SQLiteException("Value isn't a blob");
+        }
+    };
+
+    /**
+     *  Owning copy of every row a statement returned, stored row major in a
+     *  single vector.
+     */
+    class ResultSet {
+    private:
+        std::vector<std::string> names;
+        std::vector<ResultValue> values;
+    public:
+
+        /**
+         *  Default constructor creates an empty result with no columns.
+         */
+        ResultSet() {};
+
+        /**
+         *  Steps a statement until it is done, copying every row it returns.
+         *  The statement is not reset.
+         *
+         *  @param stmt - Bound statement to read the rows of
+         *
+         *  @return - ResultSet holding every row returned
+         */
+        ResultSet(StatementHandler &stmt);
+
+        /**
+         *  Returns the number of rows in the result.
+         *
+         *  @return - Number of rows
+         */
+        inline size_t rowCount() const {
+            return names.empty() ? 0 : values.size() / names.size();
+        }
+
+        /**
+         *  Returns the number of columns in the result.
+         *
+         *  @return - Number of columns
+         */
+        inline size_t columnCount() const {
+            return names.size();
+        }
+
+        /**
+         *  Returns the name SQLite gave a result column.
+         *
+         *  @param column - Integer representing the column, starting at 0
+         *
+         *  @return - Name of the column
+         */
+        inline const std::string &columnName(const size_t column) const {
+            return names.at(column);
+        }
+
+        /**
+         *  Returns the value in a given row and column.
+         *
+         *  @param row - Integer representing the row, starting at 0
+         *  @param column - Integer representing the column, starting at 0
+         *
+         *  @return - Reference to the value
+         */
+        inline const ResultValue &at(const size_t row, const size_t column) const {
+            if (column >= names.size())
+                throw SQLiteException("Column out of range");
+            return values.at(row * names.size() + column);
+        }
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,273 @@
+/**
+ *  RowRange.h
+ *  Provides an input range over the rows of a StatementHandler, for use with
+ *  range based for loops and standard algorithms
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_ROWRANGE_H
+#define SQLITER_ROWRANGE_H
+
+#include <sqlite3.h>
+#include <cstddef>
+#include <iterator>
+#include "StatementHandler.h"
+#include "Codec.h"
+#include "ColumnView.h"
+#include "ValueHandler.h"
+
+namespace SQLiter {
+
+    /**
+     *  Proxy for the current row of a statement. Columns are read by index
+     *  straight out of the statement, so a Row is only valid until the
+     *  statement is next stepped or reset. Copying a Row copies a pointer.
+     */
+    class Row {
+    private:
+        StatementHandler *stmt;
+    public:
+
+        /**
+         *  Constructor used by RowIterator.
+         *
+         *  @param statement - Statement positioned on the row
+         */
+        explicit Row(StatementHandler *statement) : stmt(statement) {};
+
+        /**
+         *  Reads a column as the given type using SQLite's conversions,
+         *  without checking the column type first.
+         *
+         *  Useage:     sqlite3_int64 id = row.get<sqlite3_int64>(0);
+         *
+         *  @param column - Integer representing the column number to read
+         *
+         *  @return - Value of the column converted to T
+         */
+        template <class T>
+        inline T get(const int column) const {
+            return Codec<T>::read(stmt->getHandle(), column);
+        }
+
+        /**
+         *  Returns a ValueHandler for a column, which converts implicitly to
+         *  the type it is assigned to.
+         *
+         *  Useage:     double price = row[2];
+         *
+         *  @param column - Integer representing the column number to read
+         *
+         *  @return - ValueHandler that wraps the column
+         */
+        inline ValueHandler operator[](const int column) const {
+            return ValueHandler(stmt->getHandle(), column);
+        }
+
+        /**
+         *  Returns the SQLite3 type of a column.
+         *
+         *  @param column - Integer representing the column number to check
+         *
+         *  @return - SQLITE_INTEGER, SQLITE_FLOAT, SQLITE_TEXT, SQLITE_BLOB or
+         *      SQLITE_NULL
+         */
+        inline int getType(const int column) const {
+            return sqlite3_column_type(stmt->getHandle(), column);
+        }
+
+        /**
+         *  Returns whether a column is NULL.
+         *
+         *  @param column - Integer representing the column number to check
+         *
+         *  @return - True if the column is NULL
+         */
+        inline bool isNull(const int column) const {
+            return getType(column) == SQLITE_NULL;
+        }
+
+        /**
+         *  Returns a view of the text in a column without copying it.
+         *
+         *  @param column - Integer representing the column number to read
+         *
+         *  @return - TextView of the text
+         */
+        inline TextView getStringView(const int column) const {
+            return stmt->getStringView(column);
+        }
+
+        /**
+         *  Returns a view of the blob in a column without copying it.
+         *
+         *  @param column - Integer representing the column number to read
+         *
+         *  @return - BlobView of the blob
+         */
+        inline BlobView getBytes(const int column) const {
+            return stmt->getBytes(column);
+        }
+
+        /**
+         *  Returns the number of columns in the row.
+         *
+         *  @return - Number of columns
+         */
+        inline int columnCount() const {
+            return sqlite3_column_count(stmt->getHandle());
+        }
+
+        /**
+         *  Gives access to the statement, for the checked and name based
+         *  getters.
+         *
+         *  @return - Pointer to the statement
+         */
+        inline StatementHandler *operator->() const {
+            return stmt;
+        }
+    };
+
+    class RowRange;
+
+    /**
+     *  Input iterator over the rows of a RowRange. Incrementing steps the
+     *  statement, so like any input iterator only one pass can be made and
+     *  every copy refers to the same position.
+     */
+    class RowIterator {
+    private:
+        RowRange *range;
+
+        /**
+         *  Returns whether the iterator is past the last row. Copies of an
+         *  iterator all see the statement run out of rows together.
+         */
+        inline bool atEnd() const;
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef Row value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Row *pointer;
+        typedef Row reference;
+
+        /**
+         *  Constructor used by RowRange. A null range is the end iterator.
+         *
+         *  @param rows - Range being iterated over
+         */
+        explicit RowIterator(RowRange *rows) : range(rows) {};
+
+        inline Row operator*() const;
+        inline RowIterator &operator++();
+
+        /**
+         *  Post increment. The returned iterator refers to the same position
+         *  as this one, as the rows of a statement can only be read once.
+         */
+        inline RowIterator operator++(int) {
+            ++*this;
+            return *this;
+        }
+
+        inline bool operator==(const RowIterator &o) const;
+
+        inline bool operator!=(const RowIterator &o) const {
+            return !(*this == o);
+        }
+    };
+
+    /**
+     *  Lazy input range over the rows of a statement, returned by
+     *  StatementHandler::rows(). The first row is stepped to when begin() is
+     *  called, each further row as the iterator is incremented. Nothing is
+     *  allocated per row.
+     *
+     *  The statement is reset when the range is destroyed, whether or not
+     *  every row was read, so it is ready to be run again. Bindings are kept.
+     *
+     *  Useage:     for (auto row : stmt->rows())
+     *                  total += row.get<double>(1);
+     *
+     *              auto rows = stmt->rows();
+     *              auto it = std::find_if(rows.begin(), rows.end(),
+     *                  [](const Row &r) { return r.get<int>(0) > 10; });
+     */
+    class RowRange {
+    private:
+        friend class RowIterator;
+
+        StatementHandler *stmt;
+        bool started;
+        bool more;
+
+        RowRange(const RowRange &) = delete;
+        RowRange &operator=(const RowRange &) = delete;
+
+    public:
+
+        /**
+         *  Constructor used by StatementHandler.
+         *
+         *  @param statement - Statement to read the rows of
+         */
+        explicit RowRange(StatementHandler *statement) :
+            stmt(statement), started(false), more(false) {};
+
+        /**
+         *  Move constructor takes over resetting the statement.
+         */
+        RowRange(RowRange &&o) : stmt(o.stmt), started(o.started), more(o.more) {
+            o.stmt = nullptr;
+        }
+
+        /**
+         *  Resets the statement.
+         */
+        ~RowRange() {
+            if (stmt != nullptr)
+                stmt->reset();
+        }
+
+        /**
+         *  Steps to the first row if that has not been done yet.
+         *
+         *  @return - Iterator at the current row, or end() if there are none
+         */
+        inline RowIterator begin() {
+            if (!started) {
+                started = true;
+                more = stmt->step();
+            }
+            return RowIterator(more ? this : nullptr);
+        }
+
+        /**
+         *  @return - Iterator past the last row
+         */
+        inline RowIterator end() {
+            return RowIterator(nullptr);
+        }
+    };
+
+    inline Row RowIterator::operator*() const {
+        return Row(range->stmt);
+    }
+
+    inline RowIterator &RowIterator::operator++() {
+        range->more = range->stmt->step();
+        return *this;
+    }
+
+    inline bool RowIterator::operator==(const RowIterator &o) const {
+        return atEnd() == o.atEnd();
+    }
+
+    inline bool RowIterator::atEnd() const {
+        return range == nullptr || !range->more;
+    }
+}
+
+#endif
\ No newline at end of file
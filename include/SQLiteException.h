@@ -5,6 +5,9 @@
  *  @author William Horstkamp
  */
 
+#ifndef SQLITER_SQLITEEXCEPTION_H
+#define SQLITER_SQLITEEXCEPTION_H
+
 #include <stdexcept>
 
 namespace SQLiter{
@@ -28,4 +31,6 @@ namespace SQLiter{
          */
         SQLiteException(const char *errMsg) : std::runtime_error(errMsg) {};
     };
-}
\ No newline at end of file
+}
+
+#endif
\ No newline at end of file
@@ -4,12 +4,35 @@
  *
  *  @author William Horstkamp
  */
+
+#ifndef SQLITER_SQLITEHANDLER_H
+#define SQLITER_SQLITEHANDLER_H
+
 #include <sqlite3.h>
 #include <string>
 #include <sys/stat.h>
 #include <memory>
-#include <map>
+#include <stdexcept>
+#include <vector>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
 #include "StatementHandler.h"
+#include "ResultSet.h"
+#include "StatementCache.h"
+#include "BlobStream.h"
+#include "Script.h"
+#include "TypedStatement.h"
+#include "UserFunction.h"
+#include "NameIndex.h"
+#include "StringRef.h"
 #include "SQLiteException.h"
 
 namespace SQLiter {
@@ -26,6 +49,134 @@ namespace SQLiter {
         }
     };
 
+    /**
+     *  Connections and threads used by the asynchronous functions of an
+     *  SQLiteHandler. Defined in SQLiteHandler.cpp.
+     */
+    class AsyncWorkers;
+
+    /**
+     *  Callback receiving the result of SQLiteHandler::queryAsync. error is
+     *  empty if the query succeeded.
+     */
+    typedef std::function<void(std::exception_ptr error, ResultSet rows)> QueryCallback;
+
+    /**
+     *  Callback receiving the result of SQLiteHandler::executeAsync. error is
+     *  empty if the statement succeeded, changes holds the rows modified.
+     */
+    typedef std::function<void(std::exception_ptr error, int changes)> ExecuteCallback;
+
+    /**
+     *  Figures describing a call to SQLiteHandler::insertMany.
+     */
+    struct InsertStats {
+        size_t rows;
+        size_t statements;
+        size_t transactions;
+        double seconds;
+        double rowsPerSecond;
+    };
+
+    /**
+     *  Time taken to prepare one statement held by an SQLiteHandler, as
+     *  listed by SQLiteHandler::statementTimings. A statement registered
+     *  lazily and not yet used has prepared set to false and no time.
+     */
+    struct StatementTiming {
+        std::string key;
+        bool prepared;
+        double seconds;
+    };
+
+    /**
+     *  Slot in an SQLiteHandler's statement array. The generation is bumped
+     *  every time the slot's statement is destroyed, invalidating old
+     *  StatementIds. The StatementHandler is held inline. A statement
+     *  registered lazily keeps its SQL in the slot, with an empty
+     *  StatementHandler, until it is first used, and the slot keeps the
+     *  connection to prepare it on so a StatementId can do so by itself.
+     */
+    struct StatementSlot {
+        StatementHandler stmt;
+        sqlite3 *db;
+        std::string key;
+        std::string sql;
+        unsigned generation;
+        bool used;
+        bool prepared;
+        double prepareSeconds;
+
+        /**
+         *  Prepares the SQL held by a lazily registered slot, recording how
+         *  long it took.
+         */
+        void prepare();
+    };
+
+    /**
+     *  Lightweight handle to a statement prepared by an SQLiteHandler.
+     *
+     *  The handle points directly at the statement's slot, so using it costs
+     *  a generation check instead of a string lookup. A handle to a statement
+     *  that has been destroyed is detected rather than silently reaching
+     *  whatever statement reused its slot.
+     *
+     *  The handle can be used like a pointer to the statement, or converted
+     *  to the StatementHandler * that prepareStatement used to return. A
+     *  statement registered lazily is prepared the first time the handle is
+     *  used. Slots never move, even when the SQLiteHandler itself is moved,
+     *  so handles stay valid until the statement is destroyed.
+     */
+    class StatementId {
+    private:
+        friend class SQLiteHandler;
+        size_t slot;
+        unsigned generation;
+        StatementSlot *entry;
+
+        StatementId(const size_t slotNum, const unsigned gen, StatementSlot *slotEntry) :
+            slot(slotNum), generation(gen), entry(slotEntry) {};
+
+        /**
+         *  Returns the statement, preparing it if it was registered lazily,
+         *  or throws std::out_of_range if it has been destroyed.
+         */
+        inline StatementHandler *resolve() const {
+            if (entry == nullptr)
+                return nullptr;
+            if (entry->generation != generation || !entry->used)
+                throw std::out_of_range("Statement Does Not Exist");
+            if (!entry->prepared)
+                entry->prepare();
+            return &entry->stmt;
+        }
+    public:
+
+        /**
+         *  Default constructor creates a handle that refers to no statement.
+         */
+        StatementId() : slot((size_t)-1), generation(0), entry(nullptr) {};
+
+        /**
+         *  Allows the handle to be used like a pointer to the statement.
+         *
+         *  @return - Pointer to the statement
+         */
+        inline StatementHandler *operator->() const {
+            return resolve();
+        }
+
+        /**
+         *  Converts the handle to a pointer to the statement.
+         *
+         *  @return - Pointer to the statement
+         */
+        inline operator StatementHandler *() const {
+            return resolve();
+        }
+    };
+
     /**
      *  Class that manages an sqlite3 db and map of strings->StatementHandler to
      *  provide a flexible and simple C++11 powered wrapper for the SQLite3 C
@@ -37,22 +188,155 @@ namespace SQLiter {
         std::unique_ptr<sqlite3, Closesqlite3> db;
 
         /**
-         *  Map from string to unique_ptr<StatementHandler>
+         *  Array of prepared statements indexed by StatementId
          *
          *  Allows the user to essentially 'name' a prepared statement which,
          *  along with the creation and cleanup functions, as well as the simple
          *  interface aids in useability and maintainability of a set of prepared
-         *  statements. The StatementHandler is managed by a unique_ptr which
-         *  allows for simple deletion by the SQLiteHandler and derived classes
-         *  using map.clear() and map.erase(keytype keyvalue)
+         *  statements. Freed slots are reused by later statements. A deque
+         *  keeps every slot at the same address as slots are added, and a
+         *  moved deque keeps its elements, so pointers and StatementIds handed
+         *  out stay valid until the statement is destroyed.
+         */
+        std::deque<StatementSlot> slots;
+        std::vector<size_t> freeSlots;
+
+        /**
+         *  Secondary lookup from statement key to slot, searched without
+         *  allocating a std::string.
+         */
+        NameIndex<size_t> names;
+
+        /**
+         *  Returns the handle of the statement in a slot.
+         */
+        inline StatementId idOf(const size_t slot) {
+            return StatementId(slot, slots[slot].generation, &slots[slot]);
+        }
+
+        /**
+         *  Takes a free slot, or adds one, and files it under a key.
+         *
+         *  @return - Index of the slot
+         */
+        size_t takeSlot(const StringRef key);
+
+        /**
+         *  Replaces the connection, pointing every slot at the new one.
+         */
+        void setConnection(sqlite3 *connection);
+
+        /**
+         *  Destroys the statement in a slot and frees the slot.
          */
-        std::map<std::string, std::unique_ptr<StatementHandler>> stmts;
+        void freeSlot(const size_t slot);
+
+        /**
+         *  Statements prepared through cached(), keyed by their SQL text
+         */
+        StatementCache cache;
+
+        /**
+         *  Location of the open database file, empty if the database is in
+         *  memory. Used to open the connections of the asynchronous functions.
+         */
+        std::string path;
+
+        /**
+         *  Worker connections and threads, started on the first asynchronous
+         *  call and stopped whenever the database is closed or replaced.
+         */
+        std::unique_ptr<AsyncWorkers> async;
+        unsigned asyncThreads;
+        bool asyncWal;
+        std::mutex asyncLock;
+
+        /**
+         *  Hands a task to the asynchronous workers, starting them if needed.
+         *
+         *  @param write - Whether the task runs on the write connection
+         *  @param task - Function run on a worker thread with a pooled
+         *      connection to the same database file
+         */
+        void submitAsync(const bool write, std::function<void(SQLiteHandler &)> task);
+
+        /**
+         *  Stops the asynchronous workers, waiting for queued tasks to finish.
+         */
+        void stopAsync();
+
+        /**
+         *  Takes over every member of another SQLiteHandler apart from its
+         *  mutex, which the caller holds, leaving it with no database open.
+         */
+        void takeFrom(SQLiteHandler &o);
+
+        /**
+         *  Works out how many rows a single INSERT statement of insertMany can
+         *  hold, from the connection's variable limit capped at 999 variables.
+         *  Multi row VALUES needs SQLite 3.7.11, older libraries insert one
+         *  row per statement.
+         *
+         *  @param columns - Number of columns inserted per row
+         *
+         *  @return - Number of rows per statement, at least 1
+         */
+        size_t insertRowsPerStatement(const size_t columns);
+
+        /**
+         *  Builds INSERT INTO table (columns) VALUES (?,...),... for a number
+         *  of rows.
+         */
+        std::string insertSQL(const StringRef table, const std::vector<std::string> &columns,
+            const size_t rows);
+
+        /**
+         *  Runs a bound INSERT statement and resets it, throwing if it failed.
+         *
+         *  @param stmt - Statement to run
+         */
+        void runInsert(StatementHandler *stmt);
+
+        /**
+         *  Registers a function with sqlite3_create_function_v2, adding
+         *  SQLITE_DETERMINISTIC when asked for and supported by the library.
+         */
+        void createFunction(const std::string name, const int nArg, const bool deterministic,
+            void *pApp, void(*xFunc)(sqlite3_context*, int, sqlite3_value**),
+            void(*xStep)(sqlite3_context*, int, sqlite3_value**),
+            void(*xFinal)(sqlite3_context*), void(*xDestroy)(void*));
+
+        /**
+         *  Registers a window function with sqlite3_create_window_function,
+         *  throwing if SQLite is too old to have it.
+         */
+        void createWindowFunction(const std::string name, const int nArg, const bool deterministic,
+            void(*xStep)(sqlite3_context*, int, sqlite3_value**),
+            void(*xFinal)(sqlite3_context*), void(*xValue)(sqlite3_context*),
+            void(*xInverse)(sqlite3_context*, int, sqlite3_value**));
+
+        /**
+         *  Binds the values of a tuple to consecutive variables.
+         *
+         *  @return - SQLITE_OK or the first failing result code
+         */
+        template <class Tuple, size_t... Is>
+        static int bindTuple(sqlite3_stmt *stmt, const int first, const Tuple &row, IndexList<Is...>) {
+            const int results[] = { SQLITE_OK, Codec<typename std::decay<
+                typename std::tuple_element<Is, Tuple>::type>::type>::bind(
+                stmt, first + (int)Is, std::get<Is>(row))... };
+            for (size_t i = 0; i < sizeof(results) / sizeof(results[0]); i++) {
+                if (results[i] != SQLITE_OK)
+                    return results[i];
+            }
+            return SQLITE_OK;
+        }
 
     public:
         /**
          *  Default constructor
          */
-        SQLiteHandler() {};
+        SQLiteHandler();
 
         /**
          *  Constructor takes a file location and opens the database file at that
@@ -72,6 +356,38 @@ namespace SQLiter {
          */
         ~SQLiteHandler();
 
+        SQLiteHandler(SQLiteHandler const &) = delete;
+
+        SQLiteHandler &operator=(SQLiteHandler const &) = delete;
+
+        /**
+         *  Move constructor takes over the database, its statements, the
+         *  statement cache and any running asynchronous workers, leaving o
+         *  with no database open. Statements stay where they are, so
+         *  StatementIds, including those of statements registered lazily and
+         *  not prepared yet, and pointers to statements, including cached
+         *  ones, carry over to the new SQLiteHandler. The mutex guarding the
+         *  asynchronous workers is not moved; o's is held while its workers
+         *  are taken over.
+         *
+         *  Useage:     std::vector<SQLiteHandler> perThread;
+         *              perThread.emplace_back(SQLiteHandler("data.db3"));
+         *
+         *  @param o - SQLiteHandler to move from
+         */
+        SQLiteHandler(SQLiteHandler &&o) noexcept;
+
+        /**
+         *  Move assignment operator closes the database held, as
+         *  closeDatabase does, which invalidates the StatementIds of its own
+         *  statements, then takes over o's as the move constructor does.
+         *
+         *  @param o - SQLiteHandler to move from
+         *
+         *  @return - Reference to this SQLiteHandler
+         */
+        SQLiteHandler &operator=(SQLiteHandler &&o) noexcept;
+
         /**
          *  Creates a new SQLite3 database at a given path and opens it.
          *
@@ -146,51 +462,210 @@ namespace SQLiter {
 
         /**
          *  Creates a StatementHandler based on a given input string,
-         *  prepares the statement, and places it in our statement map with
-         *  a given key.
+         *  prepares the statement, and places it in our statement array with
+         *  a given key. If the key is already in use the existing statement is
+         *  kept, prepared if it was registered lazily, and its handle returned.
          *
          *  @param key - Key to use to reference prepared statement
          *  @param stmtStr - String to use to build the prepared statement with.
          *      Must be in standard SQLite3 format
          *
-         *  @return - Pointer to the newly created StatementHandler.
+         *  @return - Handle to the newly created StatementHandler, which also
+         *      converts to a pointer to it.
+         */
+        StatementId prepareStatement(const StringRef key, const StringRef stmtStr);
+
+        /**
+         *  Places a statement in our statement array with a given key without
+         *  preparing it. The statement is prepared by the first getStatement
+         *  call that reaches it, or by prepareRegistered, so statements that
+         *  are rarely used cost nothing at startup. If the key is already in
+         *  use the existing statement is kept and its handle returned.
+         *
+         *  Using the handle, or converting it to a pointer, prepares the
+         *  statement if it has not been prepared yet.
+         *
+         *  Useage:     StatementId find = db.registerStatement("find",
+         *                  "SELECT name FROM users WHERE id = ?");
+         *              find->bind(1, 7);
+         *
+         *  @param key - Key to use to reference the statement
+         *  @param stmtStr - SQL of the statement, copied until it is prepared
+         *
+         *  @return - Handle to the statement
+         */
+        StatementId registerStatement(const StringRef key, const StringRef stmtStr);
+
+        /**
+         *  Registers every statement of a manifest with registerStatement.
+         *  Each statement is introduced by a comment line giving its key,
+         *  followed by its SQL. Anything before the first such line is
+         *  ignored.
+         *
+         *  Useage:     -- name: findUser
+         *              SELECT name FROM users WHERE id = ?;
+         *
+         *              -- name: addUser
+         *              INSERT INTO users (name) VALUES (?);
+         *
+         *  @param manifest - Text of the manifest
+         *
+         *  @return - Number of statements in the manifest
+         */
+        size_t registerManifest(const StringRef manifest);
+
+        /**
+         *  Reads a manifest file, as described by registerManifest, and
+         *  registers every statement in it.
+         *
+         *  @param location - Location on disk of the manifest
+         *
+         *  @return - Number of statements in the manifest
+         */
+        size_t loadManifest(const std::string location);
+
+        /**
+         *  Reads the whole of a manifest file, as described by
+         *  registerManifest, without registering anything.
+         *
+         *  @param location - Location on disk of the manifest
+         *
+         *  @return - Text of the manifest
          */
-        StatementHandler *prepareStatement(const std::string key, const std::string stmtStr);
+        static std::string readManifest(const std::string location);
+
+        /**
+         *  Prepares every statement registered lazily that has not been used
+         *  yet, for example on a background thread after startup.
+         *
+         *  @return - Number of statements prepared
+         */
+        size_t prepareRegistered();
+
+        /**
+         *  Lists every statement in the statement array with how long it took
+         *  to prepare, in the order of their slots.
+         *
+         *  @return - Key, whether prepared and seconds taken per statement
+         */
+        std::vector<StatementTiming> statementTimings() const;
+
+        /**
+         *  Returns a pointer to a StatementHandler given its handle.
+         *  This is the fastest way to reach a statement in a tight loop.
+         *
+         *  @param id - Handle returned by prepareStatement
+         *
+         *  @return - Pointer to the statement's StatementHandler
+         */
+        inline StatementHandler *getStatement(const StatementId id) {
+            if (id.slot < slots.size() && &slots[id.slot] == id.entry)
+                return id.resolve();
+            throw std::out_of_range("Statement Does Not Exist");
+        }
 
         /**
          *  Returns a pointer to a StatementHandler given its key.
          *  This is used as a way to access the statement's various functions.
+         *  The key is searched for without being copied.
          *
-         *  @param key - C string containing the key to the Statement
+         *  @param key - String containing the key to the Statement
          *
          *  @return - Pointer to the statement's StatementHandler
          */
-        StatementHandler *getStatement(const std::string key);
+        StatementHandler *getStatement(const StringRef key);
+
+        /**
+         *  Returns the handle of a statement given its key, so later lookups
+         *  can skip the string search.
+         *
+         *  @param key - String containing the key to the Statement
+         *
+         *  @return - Handle to the statement
+         */
+        StatementId statementId(const StringRef key);
+
+        /**
+         *  Returns a prepared statement for the given SQL from a bounded least
+         *  recently used cache, preparing it only if it is not already cached.
+         *  Lets ad-hoc SQL be run repeatedly without being parsed every time
+         *  and without having to invent a key for it.
+         *
+         *  The statement is reset but keeps its previous bindings. The pointer
+         *  is only valid until the next call to cached(), which may evict it.
+         *
+         *  Useage:     auto stmt = db.cached("SELECT b FROM t WHERE a = ?");
+         *              stmt->bind(1, 5);
+         *
+         *  @param stmtStr - SQL text of the statement
+         *
+         *  @return - Pointer to the cached StatementHandler
+         */
+        StatementHandler *cached(const StringRef stmtStr);
+
+        /**
+         *  Sets the largest number of statements kept by cached(). Defaults to
+         *  64.
+         *
+         *  @param maxSize - Largest number of cached statements, at least 1
+         */
+        void setCacheCapacity(const size_t maxSize);
+
+        /**
+         *  Returns the hit, miss and eviction counters of cached().
+         *
+         *  @return - Counters since the SQLiteHandler was created
+         */
+        CacheStats cacheStats();
 
         /**
          *  Deletes a prepared statement given its key.
          *
          *  @param key - C String containing the key to the Statement to delete
          */
-        void destroyStatement(const std::string key);
+        void destroyStatement(const StringRef key);
+
+        /**
+         *  Deletes a prepared statement given its handle.
+         *
+         *  @param id - Handle of the Statement to delete
+         */
+        void destroyStatement(const StatementId id);
 
         /**
-         *  Destroys all prepared statements by clearing the statement map.
+         *  Destroys all prepared statements by clearing the statement array
+         *  and the statement cache.
          *  Can be called to clear all prepared statements and is called by the
          *  SQLiteHandler destructor to prevent memory leaks.
          */
         void destroyStatements();
 
         /**
-         *  Executes an SQLite3 statement without first preparing it and
-         *  binding it. Returns number of changed rows.
+         *  Executes one or more SQLite3 statements without first preparing
+         *  them and binding them. Returns number of changed rows.
+         *
+         *  @param input - String containing the SQL statements to be
+         *      executed, which need not be null terminated
+         *
+         *  @return - Number of rows modified by the last statement
+         */
+        int rawExec(const StringRef stmtStr);
+
+        /**
+         *  Splits a string of one or more SQL statements into a Script that
+         *  keeps every statement prepared, for SQL that is run repeatedly.
+         *  The Script must be destroyed before the database is closed.
+         *
+         *  Useage:     auto nightly = db.script("DELETE FROM a; VACUUM;");
+         *              nightly->run();
          *
-         *  @param input - location to null terminated character string containing
-         *      the SQL statement to be executed
+         *  @param stmtStr - One or more SQL statements separated by semicolons
+         *  @param transaction - Whether each run of the script happens inside
+         *      a single transaction
          *
-         *  @return - Number of rows modified
+         *  @return - unique_ptr to the Script
          */
-        int rawExec(const std::string stmtStr);
+        std::unique_ptr<Script> script(const StringRef stmtStr, const bool transaction = false);
 
         /**
          *  Checks to make sure the result code returned by an SQLite3 function
@@ -217,6 +692,40 @@ namespace SQLiter {
             void(*xFunc)(sqlite3_context*, int, sqlite3_value**),
             void(*xDestroy)(void*));
 
+        /**
+         *  Creates a scalar SQLite function from any callable, including a
+         *  lambda holding state. The number and types of the arguments and the
+         *  result type are deduced from the callable, and each value is
+         *  decoded and encoded through Codec, so types of your own can be
+         *  used once their Codec reads sqlite3_values. Arguments taken as
+         *  StringRef or std::string_view point straight into SQLite's memory
+         *  and cost no allocation. A void callable returns NULL, and an
+         *  exception thrown by the callable becomes the error of the SQL
+         *  statement calling it.
+         *
+         *  A deterministic function always gives the same result for the same
+         *  arguments, which lets SQLite evaluate constant calls once and use
+         *  the function in indexes. The flag needs SQLite 3.8.3 and is
+         *  ignored by older versions.
+         *
+         *  Useage:     db.scalarFunction("clamp", [](double v, double lo, double hi) {
+         *                  return std::min(std::max(v, lo), hi);
+         *              }, true);
+         *
+         *  @param name - Name of the SQL function
+         *  @param func - Callable with a single, non-template operator()
+         *  @param deterministic - Whether the function is deterministic
+         */
+        template <class F>
+        void scalarFunction(const std::string name, F func, const bool deterministic = false) {
+            typedef typename std::decay<F>::type Func;
+            // SQLite owns the copy from here on and destroys it even if
+            // registration fails
+            Func *state = new Func(std::move(func));
+            createFunction(name, (int)FunctionTraits<Func>::arity, deterministic, state,
+                &ScalarFunction<Func>::call, nullptr, nullptr, &ScalarFunction<Func>::destroy);
+        }
+
         /**
          *  Creates an aggregate SQLite function using a set of C/C++ functions
          *
@@ -233,6 +742,69 @@ namespace SQLiter {
             void(*xFinal)(sqlite3_context*),
             void(*xDestroy)(void*));
 
+        /**
+         *  Creates an aggregate SQLite function from a class. Agg must be
+         *  default constructible and have a single step member function, whose
+         *  arguments are the SQL arguments, and a final member function giving
+         *  the result. Arguments and the result go through Codec as they do
+         *  for the typed scalarFunction, and exceptions become SQL errors.
+         *
+         *  Each group's Agg is constructed in place inside SQLite's aggregate
+         *  context on the group's first row and destroyed after final, so a
+         *  GROUP BY over millions of groups makes no allocations of its own.
+         *  A group with no rows gets final of a freshly constructed Agg.
+         *
+         *  Useage:     struct Mean {
+         *                  double sum = 0; sqlite3_int64 n = 0;
+         *                  void step(double v) { sum += v; n++; }
+         *                  double final() { return n ? sum / n : 0.0; }
+         *              };
+         *              db.aggregateFunction<Mean>("mean");
+         *
+         *  @param name - Name of the SQL function
+         *  @param deterministic - Whether the function is deterministic, see
+         *      scalarFunction
+         */
+        template <class Agg>
+        void aggregateFunction(const std::string name, const bool deterministic = false) {
+            createFunction(name, (int)FunctionTraits<decltype(&Agg::step)>::arity, deterministic,
+                nullptr, nullptr, &AggregateFunction<Agg>::step, &AggregateFunction<Agg>::final,
+                nullptr);
+        }
+
+        /**
+         *  Creates an aggregate window function from a class, so running and
+         *  sliding window results are computed inside SQLite in constant time
+         *  per row. Agg is written as for aggregateFunction, plus an inverse
+         *  member function taking the same arguments as step, which removes a
+         *  row leaving the window frame, and a value member function giving
+         *  the result for the current frame. final may be left out, in which
+         *  case value also gives the last result. The function can also be
+         *  used as an ordinary aggregate.
+         *
+         *  Window functions need SQLite 3.25.0, both to build against and to
+         *  run with; otherwise this throws an SQLiteException.
+         *
+         *  Useage:     struct MovingSum {
+         *                  double sum = 0;
+         *                  void step(double v) { sum += v; }
+         *                  void inverse(double v) { sum -= v; }
+         *                  double value() const { return sum; }
+         *              };
+         *              db.windowFunction<MovingSum>("msum");
+         *              db.rawExec("SELECT msum(v) OVER (ORDER BY t ROWS 9 PRECEDING) FROM s");
+         *
+         *  @param name - Name of the SQL function
+         *  @param deterministic - Whether the function is deterministic, see
+         *      scalarFunction
+         */
+        template <class Agg>
+        void windowFunction(const std::string name, const bool deterministic = false) {
+            createWindowFunction(name, (int)FunctionTraits<decltype(&Agg::step)>::arity,
+                deterministic, &WindowFunction<Agg>::step, &WindowFunction<Agg>::final,
+                &WindowFunction<Agg>::value, &WindowFunction<Agg>::inverse);
+        }
+
         /**
          *  Function deletes a user created function by name
          *
@@ -249,6 +821,13 @@ namespace SQLiter {
          */
         int changes();
 
+        /**
+         *  Returns the rowid of the last row inserted on the connection.
+         *
+         *  @return - rowid of the last inserted row, 0 if none
+         */
+        sqlite3_int64 lastInsertRowid();
+
         /**
          *  Returns the number of changes in all INSERT, UPDATE, or DELETE
          *      statement since the database has been opened.
@@ -267,6 +846,94 @@ namespace SQLiter {
          */
         int errorCode();
 
+        /**
+         *  Inserts every row of a range into a table using multi row
+         *  INSERT ... VALUES (?,?),(?,?),... statements sized to the
+         *  connection's variable limit, up to 999 variables. The full size statement is prepared
+         *  once and reused, a smaller one is prepared for the rows left over.
+         *
+         *  Unless a transaction is already open, every chunksPerTransaction
+         *  statements are wrapped in a transaction of their own. If an insert
+         *  fails the open transaction is rolled back and the exception
+         *  rethrown, leaving earlier transactions committed. Inside a caller's
+         *  transaction nothing is committed or rolled back.
+         *
+         *  The table and column names are written into the SQL as given.
+         *
+         *  Useage:     std::vector<std::tuple<int, std::string>> rows = ...;
+         *              InsertStats stats = db.insertMany("people", {"id", "name"}, rows);
+         *
+         *  @param table - Table to insert into
+         *  @param columns - Columns to insert, one per tuple element
+         *  @param rows - Forward range of std::tuple (or std::pair) values
+         *  @param chunksPerTransaction - Statements run per transaction
+         *
+         *  @return - InsertStats giving the rows inserted and the rate
+         */
+        template <class Range>
+        InsertStats insertMany(const StringRef table, const std::vector<std::string> &columns,
+            const Range &rows, const size_t chunksPerTransaction = 64) {
+            typedef typename std::decay<decltype(*std::begin(rows))>::type Tuple;
+            const size_t width = std::tuple_size<Tuple>::value;
+            if (columns.size() != width)
+                throw SQLiteException("Column Count Does Not Match Rows");
+
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            const size_t total = (size_t)std::distance(std::begin(rows), std::end(rows));
+            const size_t perStatement = insertRowsPerStatement(width);
+            const size_t perTransaction = perStatement * std::max(chunksPerTransaction, (size_t)1);
+            const bool ownTransactions = sqlite3_get_autocommit(db.get()) != 0;
+
+            InsertStats stats = { 0, 0, 0, 0.0, 0.0 };
+            StatementHandler *full = nullptr;
+            std::unique_ptr<StatementHandler> rest;
+            bool inTransaction = false;
+            auto row = std::begin(rows);
+            try {
+                while (stats.rows < total) {
+                    if (ownTransactions && !inTransaction) {
+                        rawExec("BEGIN");
+                        inTransaction = true;
+                    }
+                    const size_t count = std::min(perStatement, total - stats.rows);
+                    StatementHandler *stmt;
+                    if (count == perStatement) {
+                        if (full == nullptr)
+                            full = cached(insertSQL(table, columns, count));
+                        stmt = full;
+                    } else {
+                        rest.reset(new StatementHandler(db.get(), insertSQL(table, columns, count)));
+                        if (rest->getHandle() == nullptr)
+                            result(errorCode());
+                        stmt = rest.get();
+                    }
+                    for (size_t i = 0; i < count; i++, ++row) {
+                        result(bindTuple(stmt->getHandle(), (int)(i * width) + 1, *row,
+                            typename MakeIndexList<std::tuple_size<Tuple>::value>::type()));
+                    }
+                    runInsert(stmt);
+                    stats.rows += count;
+                    stats.statements++;
+                    if (inTransaction && (stats.rows % perTransaction == 0 || stats.rows == total)) {
+                        rawExec("COMMIT");
+                        inTransaction = false;
+                        stats.transactions++;
+                    }
+                }
+            } catch (...) {
+                if (inTransaction) {
+                    try {
+                        rawExec("ROLLBACK");
+                    } catch (...) {}
+                }
+                throw;
+            }
+
+            stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            stats.rowsPerSecond = stats.seconds > 0.0 ? stats.rows / stats.seconds : 0.0;
+            return stats;
+        }
+
         /**
          *  Returns an English language message describing the last error
          *      incurred on the database.
@@ -275,5 +942,169 @@ namespace SQLiter {
          *      result message generated by the database connection.
          */
         const std::string errorMsg();
+
+        /**
+         *  Sets how long the connection will wait on a locked database before
+         *  giving up and returning SQLITE_BUSY. Needed whenever several
+         *  connections share a single database file.
+         *
+         *  @param ms - Number of milliseconds to wait, 0 turns waiting off
+         */
+        void busyTimeout(const int ms);
+
+        /**
+         *  Opens a blob for incremental reading, and optionally writing, in
+         *  chunks. See BlobStream. The BlobStream must be destroyed before
+         *  the database is closed.
+         *
+         *  Useage:     auto blob = db.openBlob("images", "data", rowid);
+         *              std::istream in(blob.get());
+         *
+         *  @param table - Table holding the blob
+         *  @param column - Column holding the blob
+         *  @param row - Rowid of the row holding the blob
+         *  @param write - Whether the blob is opened for writing
+         *  @param database - Name of the database, "main" unless attached
+         *  @param chunkSize - Size of the buffer used by the stream functions
+         *
+         *  @return - unique_ptr to the open BlobStream
+         */
+        std::unique_ptr<BlobStream> openBlob(const std::string table, const std::string column,
+            const sqlite3_int64 row, const bool write = false, const std::string database = "main",
+            const size_t chunkSize = 65536);
+
+        /**
+         *  Sets the number of read connections, and threads reading from them,
+         *  used by the asynchronous functions. Takes effect the next time the
+         *  workers are started. Defaults to the number of hardware threads.
+         *
+         *  @param threads - Number of read threads, 0 for the default
+         */
+        void setAsyncThreads(const unsigned threads);
+
+        /**
+         *  Sets whether starting the asynchronous workers switches the
+         *  database to WAL journaling, which lets the worker reads run while
+         *  a write is in progress. The change is stored in the database file
+         *  and stays after the SQLiteHandler is closed, so it is off unless
+         *  asked for. Takes effect the next time the workers are started.
+         *
+         *  @param wal - Whether to switch the database to WAL journaling
+         */
+        void setAsyncWal(const bool wal);
+
+        /**
+         *  Runs a query on a worker thread using a pooled read connection to
+         *  the same database file, so the calling thread never waits on disk.
+         *  Only available for databases opened from a file.
+         *
+         *  The first asynchronous call opens the worker connections, which
+         *  write to the file alongside this SQLiteHandler, and sets a busy
+         *  timeout of 5 seconds on this SQLiteHandler's own connection so its
+         *  writes wait for theirs. The journal mode is left alone unless
+         *  setAsyncWal was called.
+         *
+         *  Useage:     auto rows = db.queryAsync("SELECT * FROM t WHERE a = ?", 5);
+         *
+         *  @param stmtStr - SQL query to run
+         *  @param args - Values to bind to the query's variables, in order
+         *
+         *  @return - Future that receives every row returned by the query
+         */
+        template <class... Args>
+        std::future<ResultSet> queryAsync(const std::string stmtStr, Args... args) {
+            std::shared_ptr<std::promise<ResultSet>> done(new std::promise<ResultSet>());
+            std::future<ResultSet> res = done->get_future();
+            queryAsync([done](std::exception_ptr error, ResultSet rows) {
+                if (error)
+                    done->set_exception(error);
+                else
+                    done->set_value(std::move(rows));
+            }, stmtStr, args...);
+            return res;
+        }
+
+        /**
+         *  Runs a query on a worker thread using a pooled read connection to
+         *  the same database file and hands the result to a callback, which is
+         *  called on the worker thread.
+         *
+         *  @param callback - Function receiving the rows or the error
+         *  @param stmtStr - SQL query to run
+         *  @param args - Values to bind to the query's variables, in order
+         */
+        template <class... Args>
+        void queryAsync(QueryCallback callback, const std::string stmtStr, Args... args) {
+            submitAsync(false, [=](SQLiteHandler &conn) {
+                ResultSet rows;
+                std::exception_ptr error;
+                try {
+                    StatementHandler *stmt = conn.cached(stmtStr);
+                    stmt->clear();
+                    stmt->bindAll(args...);
+                    rows = ResultSet(*stmt);
+                    const int resCode = conn.errorCode();
+                    stmt->reset();
+                    conn.result(resCode);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                callback(error, std::move(rows));
+            });
+        }
+
+        /**
+         *  Runs a statement on a worker thread using the pooled write
+         *  connection to the same database file.
+         *
+         *  @param stmtStr - SQL statement to run
+         *  @param args - Values to bind to the statement's variables, in order
+         *
+         *  @return - Future that receives the number of rows modified
+         */
+        template <class... Args>
+        std::future<int> executeAsync(const std::string stmtStr, Args... args) {
+            std::shared_ptr<std::promise<int>> done(new std::promise<int>());
+            std::future<int> res = done->get_future();
+            executeAsync([done](std::exception_ptr error, int changes) {
+                if (error)
+                    done->set_exception(error);
+                else
+                    done->set_value(changes);
+            }, stmtStr, args...);
+            return res;
+        }
+
+        /**
+         *  Runs a statement on a worker thread using the pooled write
+         *  connection to the same database file and hands the result to a
+         *  callback, which is called on the worker thread.
+         *
+         *  @param callback - Function receiving the rows modified or the error
+         *  @param stmtStr - SQL statement to run
+         *  @param args - Values to bind to the statement's variables, in order
+         */
+        template <class... Args>
+        void executeAsync(ExecuteCallback callback, const std::string stmtStr, Args... args) {
+            submitAsync(true, [=](SQLiteHandler &conn) {
+                int changed = 0;
+                std::exception_ptr error;
+                try {
+                    StatementHandler *stmt = conn.cached(stmtStr);
+                    stmt->clear();
+                    stmt->bindAll(args...);
+                    while (stmt->step()) {}
+                    const int resCode = conn.errorCode();
+                    stmt->reset();
+                    conn.result(resCode);
+                    changed = conn.changes();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                callback(error, changed);
+            });
+        }
     };
-}
\ No newline at end of file
+}
+
+#endif
\ No newline at end of file
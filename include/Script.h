@@ -0,0 +1,128 @@
+/**
+ *  Script.h
+ *  Provides a sequence of SQL statements that is parsed once and can be run
+ *  any number of times
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_SCRIPT_H
+#define SQLITER_SCRIPT_H
+
+#include <sqlite3.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "StatementHandler.h"
+#include "StringRef.h"
+
+namespace SQLiter {
+
+    /**
+     *  Multi statement SQL string split into its statements, each of which
+     *  stays prepared between runs so running the script again does no
+     *  parsing.
+     *
+     *  Statements are prepared as the script first reaches them, so a
+     *  statement may use a table created by an earlier statement of the same
+     *  script. After the first complete run every statement is prepared.
+     *
+     *  Optionally the whole script runs inside a single transaction, rolled
+     *  back if any statement fails. The script must not then contain BEGIN
+     *  or COMMIT itself.
+     *
+     *  Every Script must be destroyed before its database is closed.
+     *
+     *  Useage:     auto cleanup = db.script(
+     *                  "DELETE FROM log WHERE ts < strftime('%s','now') - 86400;"
+     *                  "UPDATE stats SET rows = (SELECT count(*) FROM log);", true);
+     *              cleanup->run();
+     */
+    class Script {
+    private:
+        typedef std::unique_ptr<sqlite3_stmt, Closesqlite3_stmt> Statement;
+
+        sqlite3 *db;
+        std::string sql;
+        bool transaction;
+
+        /**
+         *  Statements prepared so far and the offset in sql at which the next
+         *  statement starts
+         */
+        std::vector<Statement> statements;
+        size_t parsed;
+
+        Statement begin;
+        Statement commit;
+        Statement rollback;
+
+        Script(const Script &) = delete;
+        Script &operator=(const Script &) = delete;
+
+        /**
+         *  Prepares the next statement of the script.
+         *
+         *  @return - True if a statement was prepared, false if only
+         *      whitespace or comments were left
+         */
+        bool prepareNext();
+
+        /**
+         *  Prepares a statement used to control the transaction.
+         */
+        Statement prepare(const char *stmtStr);
+
+        /**
+         *  Steps a statement until it is done and resets it, throwing if it
+         *  failed.
+         */
+        void execute(sqlite3_stmt *stmt);
+
+    public:
+
+        /**
+         *  Constructor takes a copy of the SQL. Nothing is prepared until the
+         *  script is first run.
+         *
+         *  @param connection - Database to run the script on
+         *  @param stmtStr - One or more SQL statements separated by semicolons
+         *  @param useTransaction - Whether to run the script inside a single
+         *      transaction
+         *
+         *  @return - Script ready to run
+         */
+        Script(sqlite3 *connection, const StringRef stmtStr, const bool useTransaction = false);
+
+        /**
+         *  Runs every statement of the script in order. Rows returned by
+         *  queries are discarded. Stops at the first statement that fails and
+         *  throws an SQLiteException, after rolling back if the script runs
+         *  in a transaction.
+         *
+         *  @return - Number of rows inserted, updated or deleted
+         */
+        int run();
+
+        /**
+         *  Sets whether the script runs inside a single transaction.
+         *
+         *  @param useTransaction - Whether to use a transaction
+         */
+        inline void setTransaction(const bool useTransaction) {
+            transaction = useTransaction;
+        }
+
+        /**
+         *  Gives the number of statements prepared so far, which is every
+         *  statement of the script once it has been run.
+         *
+         *  @return - Number of prepared statements
+         */
+        inline size_t size() const {
+            return statements.size();
+        }
+    };
+}
+
+#endif
\ No newline at end of file
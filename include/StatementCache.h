@@ -0,0 +1,122 @@
+/**
+ *  StatementCache.h
+ *  Provides a bounded least recently used cache of prepared statements keyed
+ *  by their SQL text
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_STATEMENTCACHE_H
+#define SQLITER_STATEMENTCACHE_H
+
+#include <sqlite3.h>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "StatementHandler.h"
+#include "StringRef.h"
+
+namespace SQLiter {
+
+    /**
+     *  Counters describing how well a StatementCache is doing.
+     */
+    struct CacheStats {
+        unsigned long long hits;
+        unsigned long long misses;
+        unsigned long long evictions;
+    };
+
+    /**
+     *  Class that keeps up to a fixed number of prepared statements, keyed by
+     *  their SQL text. Looking up SQL that is already in the cache returns the
+     *  existing StatementHandler without calling sqlite3_prepare_v2. When the
+     *  cache is full the least recently used statement is finalized to make
+     *  room.
+     */
+    class StatementCache {
+    private:
+        typedef std::list<std::pair<std::string, std::unique_ptr<StatementHandler>>> EntryList;
+
+        size_t capacity;
+
+        /**
+         *  Cached statements, most recently used first
+         */
+        EntryList entries;
+
+        /**
+         *  Entries keyed by the hash of their SQL text, so SQL can be looked
+         *  up without copying it into a std::string. Entries sharing a hash
+         *  are told apart by comparing the text.
+         */
+        std::unordered_multimap<unsigned long long, EntryList::iterator> index;
+        CacheStats stats;
+
+        /**
+         *  Finalizes least recently used statements until the cache is within
+         *  its capacity.
+         */
+        void trim();
+
+    public:
+
+        /**
+         *  Constructor creates an empty cache.
+         *
+         *  @param maxSize - Largest number of statements kept, at least 1
+         *
+         *  @return - Empty StatementCache
+         */
+        StatementCache(const size_t maxSize = 64);
+
+        /**
+         *  Returns the cached statement for the given SQL, preparing and
+         *  caching it if it is not already present. A statement taken from the
+         *  cache is reset but keeps its previous bindings.
+         *
+         *  The returned pointer is valid until the statement is evicted, which
+         *  can happen on any later call to get().
+         *
+         *  @param db - Database to prepare the statement on
+         *  @param stmtStr - SQL text of the statement
+         *
+         *  @return - Pointer to the cached StatementHandler
+         */
+        StatementHandler *get(sqlite3 *db, const StringRef stmtStr);
+
+        /**
+         *  Changes the largest number of statements kept, evicting statements
+         *  if the cache is now over capacity.
+         *
+         *  @param maxSize - Largest number of statements kept, at least 1
+         */
+        void setCapacity(const size_t maxSize);
+
+        /**
+         *  Returns the number of statements currently cached.
+         *
+         *  @return - Number of cached statements
+         */
+        inline size_t size() const {
+            return entries.size();
+        }
+
+        /**
+         *  Returns the hit, miss and eviction counters.
+         *
+         *  @return - Counters since the cache was created
+         */
+        inline const CacheStats &getStats() const {
+            return stats;
+        }
+
+        /**
+         *  Finalizes every cached statement. Counters are kept.
+         */
+        void clear();
+    };
+}
+
+#endif
\ No newline at end of file
@@ -7,15 +7,33 @@
  *  @author William Horstkamp
  */
 
+#ifndef SQLITER_STATEMENTHANDLER_H
+#define SQLITER_STATEMENTHANDLER_H
+
 #include <sqlite3.h>
 #include <memory>
 #include <vector>
 #include <string>
-#include <map>
+#include <stdexcept>
+#include <type_traits>
 #include "ValueHandler.h"
+#include "NameIndex.h"
+#include "ColumnKey.h"
+#include "StringRef.h"
+#include "Codec.h"
+#include "ColumnView.h"
+#include "ColumnBatch.h"
+#include "StepAwaitable.h"
 
 namespace SQLiter {
 
+    class RowRange;
+
+    template <class Policy>
+    class ColumnAccess;
+
+    struct Unchecked;
+
     /**
      *  Custom deleter for unique_ptr<sqlite3_stmt>'s raw pointer
      *  implemented as an object as function
@@ -38,10 +56,48 @@ namespace SQLiter {
     private:
 
         std::unique_ptr<sqlite3_stmt, Closesqlite3_stmt> stmt;
-        std::map<const std::string , int> inputAlias;
-        std::map<const std::string , int> outputAlias;
+        NameIndex<int> inputAlias;
+        NameIndex<int> outputAlias;
+        Executor *executor;
+
+        /**
+         *  Value stored in inputAlias under a bare name shared by more than
+         *  one named variable, such as :id and @id, and in outputAlias under
+         *  a name shared by more than one result column, such as the two id
+         *  columns of SELECT a.id, b.id.
+         */
+        static const int ambiguousAlias = -1;
+
+        /**
+         *  Buffers handed over by the moving bind functions, indexed by
+         *  variable. Each is bound as SQLITE_STATIC and kept alive until the
+         *  variable is bound through a moving bind again, clear() is called or
+         *  the statement is destroyed. Sized once so the buffers never move.
+         */
+        std::vector<std::string> ownedText;
+        std::vector<std::vector<unsigned char>> ownedBlobs;
+
+        /**
+         *  Counts calls to step() and reset(), so views of column values can
+         *  tell in debug builds whether the row they refer to is still current
+         */
+        unsigned rowGeneration;
+
+        /**
+         *  Result of the latest step, SQLITE_OK after a reset. Lets
+         *  fetchColumnar stop at the end of the results instead of stepping
+         *  the statement into running again.
+         */
+        int lastResult;
     public:
 
+        /**
+         *  Default constructor creates a StatementHandler holding no
+         *  statement, the same state a StatementHandler is left in once it
+         *  has been moved from.
+         */
+        StatementHandler();
+
         /**
         *  Constructor prepares a statement on a db given a db and string.
         *
@@ -51,7 +107,7 @@ namespace SQLiter {
         *  @return - StatementHandler containing a unique_ptr that is managing
         *      a prepared statement that is ready to be bound
         */
-        StatementHandler(sqlite3 *db, const std::string stmtStr);
+        StatementHandler(sqlite3 *db, const StringRef stmtStr);
 
         /**
          *  Default Destructor cleans up our sqlite3_stmt unique_ptr and clears
@@ -72,26 +128,100 @@ namespace SQLiter {
         StatementHandler &operator=(StatementHandler const &) = delete;
 
         /**
-         *  Deletes the move assignment operator to prevent the user from
-         *  taking the prepared statement from the StatementHandler.
+         *  Move constructor takes over the prepared statement, its aliases and
+         *  the buffers bound by the moving bind functions, leaving o holding
+         *  no statement. The sqlite3_stmt itself does not move, so bindings
+         *  and the current row carry over. Pointers to o, such as those held
+         *  by a RowRange, a TypedStatement or a StatementId, and views taken
+         *  from o are not carried over and must not be used afterwards.
+         *
+         *  @param o - StatementHandler to move from
+         */
+        StatementHandler(StatementHandler &&o) noexcept;
+
+        /**
+         *  Move assignment operator finalizes the statement held, then takes
+         *  over o's as the move constructor does.
+         *
+         *  @param o - StatementHandler to move from
+         *
+         *  @return - Reference to this StatementHandler
          */
-        StatementHandler &operator=(StatementHandler &&o) = delete;
+        StatementHandler &operator=(StatementHandler &&o) noexcept;
 
         /**
-         *  Deletes the move constructor to prevent the user from taking the
-         *  prepared statement from the StatementHandler.
+         *  Binds the variable in a given position of the prepared statement
+         *  to a string as input. The length of the string is already known so
+         *  it is not measured again.
+         *
+         *  @param var - Input column as int
+         *      Begins with 1, as per the SQLite standard
+         *  @param input - C string, std::string or StringRef to bind
          */
-        StatementHandler(StatementHandler &&o) = delete;
+        void bind(const int var, const StringRef input);
 
         /**
          *  Binds the variable in a given position of the prepared statement
-         *  to a std::string  as input.
+         *  to a null terminated C string as input.
          *
          *  @param var - Input column as int
          *      Begins with 1, as per the SQLite standard
          *  @param input - pointer to C string to bind
          */
-        void bind(const int var, const std::string input);
+        inline void bind(const int var, const char *input) {
+            bind(var, StringRef(input));
+        }
+
+        /**
+         *  Binds the variable in a given position of the prepared statement
+         *  to a string, taking ownership of it instead of having SQLite copy
+         *  it. The string is kept by the StatementHandler for as long as
+         *  SQLite may read it.
+         *
+         *  Useage:     stmt.bind(1, std::move(bigString));
+         *
+         *  @param var - Input column as int
+         *      Begins with 1, as per the SQLite standard
+         *  @param input - string to move in and bind
+         */
+        void bind(const int var, std::string &&input);
+
+        /**
+         *  Binds the variable in a given position of the prepared statement
+         *  to a blob, taking ownership of it instead of having SQLite copy
+         *  it. The blob is kept by the StatementHandler for as long as SQLite
+         *  may read it.
+         *
+         *  @param var - Input column as int
+         *      Begins with 1, as per the SQLite standard
+         *  @param input - bytes to move in and bind
+         */
+        void bind(const int var, std::vector<unsigned char> &&input);
+
+        /**
+         *  Binds the variable in a given position of the prepared statement
+         *  to a string without SQLite copying it. The caller guarantees the
+         *  characters stay valid and unchanged until the variable is bound
+         *  again, the bindings are cleared or the statement is destroyed.
+         *
+         *  @param var - Input column as int
+         *      Begins with 1, as per the SQLite standard
+         *  @param input - string to bind, which must outlive the binding
+         */
+        void bindStatic(const int var, const StringRef input);
+
+        /**
+         *  Binds the variable in a given position of the prepared statement
+         *  to a blob without SQLite copying it. The caller guarantees the
+         *  bytes stay valid and unchanged until the variable is bound again,
+         *  the bindings are cleared or the statement is destroyed.
+         *
+         *  @param var - Input column as int
+         *      Begins with 1, as per the SQLite standard
+         *  @param input - blob to bind, which must outlive the binding
+         *  @param size - size of the blob in bytes
+         */
+        void bindStatic(const int var, const void *input, const size_t size);
 
         /**
          *  Binds the variable in a given position of the prepared statement
@@ -121,7 +251,7 @@ namespace SQLiter {
          *      Begins with 1, as per the SQLite standard
          *  @param input - blob to bind
          */
-        void bind(const int var, const void *input, const int size);
+        void bind(const int var, const void *input, const size_t size);
 
         /**
          *  Binds the variable in a given position of the prepared statement
@@ -131,15 +261,124 @@ namespace SQLiter {
          */
         void bindNull(const int var);
 
+        /**
+         *  Binds any value with a Codec to the variable in a given position of
+         *  the prepared statement, chosen at compile time. bool binds as 0 or
+         *  1, integers of every width and signedness as 64 bit integers and
+         *  float as double. Unsigned values too large for a signed 64 bit
+         *  integer throw an SQLiteException. std::optional binds null when
+         *  empty, and types of your own bind through their Codec
+         *  specialization.
+         *
+         *  Useage:     stmt.bind(1, (sqlite3_int64)id);
+         *              stmt.bind(2, vec.size());
+         *              stmt.bind(3, true);
+         *              stmt.bind(4, uuid);
+         *
+         *  @param var - Integer representing the variable to bind to
+         *  @param input - value to bind
+         */
+        template <class T>
+        inline typename std::enable_if<BindsThroughCodec<T>::value>::type
+            bind(const int var, const T &input) {
+            Codec<T>::bind(stmt.get(), var, input);
+        }
+
+        /**
+         *  Binds the variable in a given position of the prepared statement
+         *  to a blob of zeros without allocating it. Used to make room for a
+         *  blob that is then written in pieces through a BlobStream. Sizes
+         *  beyond INT_MAX need SQLite 3.8.11 headers, as bindBlob does for
+         *  3.8.7, and otherwise throw an SQLiteException.
+         *
+         *  @param var - Integer representing the variable to bind to
+         *  @param size - Size of the blob in bytes
+         */
+        void bindZeroBlob(const int var, const size_t size);
+
+        /**
+         *  Binds each of the given values in order, starting with the first
+         *  variable of the prepared statement. Every value must be of a type
+         *  accepted by one of the positional bind functions.
+         *
+         *  Useage:     stmt.bindAll("A String", 5.0, 3);
+         *
+         *  @param args - Values to bind to variables 1 through sizeof...(args)
+         */
+        template <class... Args>
+        inline void bindAll(const Args &... args) {
+            bindFrom(1, args...);
+        }
+
         /**
          *  Binds the variable with a given alias in the prepared statement
-         *  to a std::string  as input.
+         *  to a string as input.
+         *
+         *  @param var - the alias of the prepared statement that the input is for.
+         *  @param input - C string, std::string or StringRef to bind
+         */
+        inline void bind(const StringRef var, const StringRef input) {
+            bind(inputIndex(var), input);
+        }
+
+        /**
+         *  Binds the variable with a given alias in the prepared statement
+         *  to a null terminated C string as input.
          *
          *  @param var - the alias of the prepared statement that the input is for.
          *  @param input - pointer to C string to bind
          */
-        inline void bind(const std::string var, const std::string input) {
-            bind(inputAlias.at(var), input);
+        inline void bind(const StringRef var, const char *input) {
+            bind(inputIndex(var), StringRef(input));
+        }
+
+        /**
+         *  Binds the variable with a given alias in the prepared statement
+         *  to a string, taking ownership of it instead of having SQLite copy
+         *  it.
+         *
+         *  @param var - the alias of the prepared statement that the input is for.
+         *  @param input - string to move in and bind
+         */
+        inline void bind(const StringRef var, std::string &&input) {
+            bind(inputIndex(var), std::move(input));
+        }
+
+        /**
+         *  Binds the variable with a given alias in the prepared statement
+         *  to a blob, taking ownership of it instead of having SQLite copy
+         *  it.
+         *
+         *  @param var - the alias of the prepared statement that the input is for.
+         *  @param input - bytes to move in and bind
+         */
+        inline void bind(const StringRef var, std::vector<unsigned char> &&input) {
+            bind(inputIndex(var), std::move(input));
+        }
+
+        /**
+         *  Binds the variable with a given alias in the prepared statement
+         *  to a string without SQLite copying it. See
+         *  bindStatic(const int, const StringRef).
+         *
+         *  @param var - the alias of the prepared statement that the input is for.
+         *  @param input - string to bind, which must outlive the binding
+         */
+        inline void bindStatic(const StringRef var, const StringRef input) {
+            bindStatic(inputIndex(var), input);
+        }
+
+        /**
+         *  Binds the variable with a given alias in the prepared statement
+         *  to a blob without SQLite copying it. See
+         *  bindStatic(const int, const void *, const size_t).
+         *
+         *  @param var - the alias of the prepared statement that the input is for.
+         *  @param input - blob to bind, which must outlive the binding
+         *  @param size - size of the blob in bytes
+         */
+        inline void bindStatic(const StringRef var, const void *input, const size_t size) {
+            bindStatic(inputIndex(var), input, size);
         }
 
         /**
@@ -149,8 +388,8 @@ namespace SQLiter {
          *  @param var - the alias of the prepared statement that the input is for
          *  @param input - int to bind
          */
-        inline void bind(const std::string var, const int input) {
-            bind(inputAlias.at(var), input);
+        inline void bind(const StringRef var, const int input) {
+            bind(inputIndex(var), input);
         }
 
         /**
@@ -160,8 +399,8 @@ namespace SQLiter {
          *  @param var - the alias of the prepared statement that the input is for
          *  @param input - double to bind
          */
-        inline void bind(const std::string var, const double input) {
-            bind(inputAlias.at(var), input);
+        inline void bind(const StringRef var, const double input) {
+            bind(inputIndex(var), input);
         }
 
         /**
@@ -171,8 +410,8 @@ namespace SQLiter {
          *  @param var - the alias of the prepared statement that the input is for
          *  @param input - blob to bind
          */
-        inline void bind(const std::string var, const void *input, const int size) {
-            bind(inputAlias.at(var), input, size);
+        inline void bind(const StringRef var, const void *input, const size_t size) {
+            bind(inputIndex(var), input, size);
         }
 
         /**
@@ -182,8 +421,92 @@ namespace SQLiter {
          *  @param var - the alias of the prepared statement that is to be
          *      set to null
          */
-        inline void bindNull(const std::string var) {
-            sqlite3_bind_null(stmt.get(), inputAlias.at(var));
+        inline void bindNull(const StringRef var) {
+            sqlite3_bind_null(stmt.get(), inputIndex(var));
+        }
+
+        /**
+         *  Binds any value with a Codec to the variable with a given alias.
+         *  See bind(const int, const T &).
+         *
+         *  @param var - the alias of the prepared statement that the input is for
+         *  @param input - value to bind
+         */
+        template <class T>
+        inline typename std::enable_if<BindsThroughCodec<T>::value>::type
+            bind(const StringRef var, const T &input) {
+            bind(inputIndex(var), input);
+        }
+
+        /**
+         *  Binds the variable with a given alias in the prepared statement
+         *  to a blob of zeros without allocating it.
+         *
+         *  @param var - the alias of the prepared statement that the input is for
+         *  @param size - Size of the blob in bytes
+         */
+        inline void bindZeroBlob(const StringRef var, const size_t size) {
+            bindZeroBlob(inputIndex(var), size);
+        }
+
+        /**
+         *  Binds the variable named by a ColumnKey, found by comparing hashes
+         *  instead of names. Otherwise the same as the bind functions taking
+         *  an alias.
+         *
+         *  Useage:     stmt.bind(SQLITER_COL("min"), 10);
+         *
+         *  @param var - ColumnKey naming the variable, without its :, @ or $
+         *  @param input - value to bind
+         */
+        inline void bind(const ColumnKey var, const StringRef input) {
+            bind(inputIndex(var), input);
+        }
+
+        inline void bind(const ColumnKey var, const char *input) {
+            bind(inputIndex(var), StringRef(input));
+        }
+
+        inline void bind(const ColumnKey var, std::string &&input) {
+            bind(inputIndex(var), std::move(input));
+        }
+
+        inline void bind(const ColumnKey var, std::vector<unsigned char> &&input) {
+            bind(inputIndex(var), std::move(input));
+        }
+
+        inline void bindStatic(const ColumnKey var, const StringRef input) {
+            bindStatic(inputIndex(var), input);
+        }
+
+        inline void bindStatic(const ColumnKey var, const void *input, const size_t size) {
+            bindStatic(inputIndex(var), input, size);
+        }
+
+        inline void bind(const ColumnKey var, const int input) {
+            bind(inputIndex(var), input);
+        }
+
+        inline void bind(const ColumnKey var, const double input) {
+            bind(inputIndex(var), input);
+        }
+
+        inline void bind(const ColumnKey var, const void *input, const size_t size) {
+            bind(inputIndex(var), input, size);
+        }
+
+        inline void bindNull(const ColumnKey var) {
+            sqlite3_bind_null(stmt.get(), inputIndex(var));
+        }
+
+        template <class T>
+        inline typename std::enable_if<BindsThroughCodec<T>::value>::type
+            bind(const ColumnKey var, const T &input) {
+            bind(inputIndex(var), input);
+        }
+
+        inline void bindZeroBlob(const ColumnKey var, const size_t size) {
+            bindZeroBlob(inputIndex(var), size);
         }
 
         /**
@@ -274,6 +597,38 @@ namespace SQLiter {
          */
         const void *getBlob(const int column);
 
+        /**
+         *  Returns a view of the text in the specified column of the
+         *  result of the latest step without copying it.
+         *
+         *  The view is only valid until the next call to step or reset. Debug
+         *  builds assert if it is read after that.
+         *
+         *  *RESULTS ARE UNDEFINED IF A ROW WAS NOT RETURNED OR COLUMN IS INVALID*
+         *
+         *  @param column - Integer representing the column number to pull the
+         *      resultant text from
+         *
+         *  @return - TextView of the text, sized by sqlite3_column_bytes
+         */
+        TextView getStringView(const int column);
+
+        /**
+         *  Returns a view of the blob in the specified column of the
+         *  result of the latest step without copying it.
+         *
+         *  The view is only valid until the next call to step or reset. Debug
+         *  builds assert if it is read after that.
+         *
+         *  *RESULTS ARE UNDEFINED IF A ROW WAS NOT RETURNED OR COLUMN IS INVALID*
+         *
+         *  @param column - Integer representing the column number to pull the
+         *      resultant blob from
+         *
+         *  @return - BlobView of the blob, sized by sqlite3_column_bytes
+         */
+        BlobView getBytes(const int column);
+
         /**
          *  Returns a ValueHandler objects that functions as a wrapper and
          *  type converter for the range of return types that SQLite supports.
@@ -298,8 +653,8 @@ namespace SQLiter {
          *      Possible results: 1 - INT, 2 - FLOAT, 3 - TEXT, 4 - BLOB, 5 - NULL
          *      0 - ERROR
          */
-        inline const int getType(const std::string column) {
-            return getType(outputAlias.at(column));
+        inline const int getType(const StringRef column) {
+            return getType(outputIndex(column));
         }
 
         /**
@@ -310,8 +665,8 @@ namespace SQLiter {
          *  @return - Integer representing the size of the value currently in the
          *      the column, in bytes.
          */
-        inline const int getSize(const std::string column) {
-            return getSize(outputAlias.at(column));
+        inline const int getSize(const StringRef column) {
+            return getSize(outputIndex(column));
         }
 
         /**
@@ -327,8 +682,8 @@ namespace SQLiter {
          *      containing resultant text for a given column or nullptr if column
          *      contains null
          */
-        inline std::string getString(const std::string column) {
-            return getString(outputAlias.at(column));
+        inline std::string getString(const StringRef column) {
+            return getString(outputIndex(column));
         }
 
         /**
@@ -342,8 +697,8 @@ namespace SQLiter {
          *
          *  @return int - integer value
          */
-        inline int getInt(const std::string column) {
-            return getInt(outputAlias.at(column));
+        inline int getInt(const StringRef column) {
+            return getInt(outputIndex(column));
         }
 
         /**
@@ -357,8 +712,8 @@ namespace SQLiter {
          *
          *  @return int - sqlite3_int64 value
          */
-        inline sqlite3_int64 getInt64(const std::string column) {
-            return getInt64(outputAlias.at(column));
+        inline sqlite3_int64 getInt64(const StringRef column) {
+            return getInt64(outputIndex(column));
         }
 
         /**
@@ -372,8 +727,8 @@ namespace SQLiter {
          *
          *  @return double - double value
          */
-        inline double getDouble(const std::string column) {
-            return getDouble(outputAlias.at(column));
+        inline double getDouble(const StringRef column) {
+            return getDouble(outputIndex(column));
         }
 
         /**
@@ -387,8 +742,38 @@ namespace SQLiter {
          *
          *  @return - pointer to blob
          */
-        inline const void *getBlob(const std::string column) {
-            return getBlob(outputAlias.at(column));
+        inline const void *getBlob(const StringRef column) {
+            return getBlob(outputIndex(column));
+        }
+
+        /**
+         *  Returns a view of the text in the specified column of the
+         *  result of the latest step without copying it.
+         *
+         *  The view is only valid until the next call to step or reset.
+         *
+         *  @param column - C String representing the column number to pull the
+         *      resultant text from
+         *
+         *  @return - TextView of the text
+         */
+        inline TextView getStringView(const StringRef column) {
+            return getStringView(outputIndex(column));
+        }
+
+        /**
+         *  Returns a view of the blob in the specified column of the
+         *  result of the latest step without copying it.
+         *
+         *  The view is only valid until the next call to step or reset.
+         *
+         *  @param column - C String representing the column number to pull the
+         *      resultant blob from
+         *
+         *  @return - BlobView of the blob
+         */
+        inline BlobView getBytes(const StringRef column) {
+            return getBytes(outputIndex(column));
         }
 
         /**
@@ -404,8 +789,59 @@ namespace SQLiter {
          *
          *  @return - ValueHandler that wraps an SQLite3 value
          */
-        inline ValueHandler getColumn(const std::string column) {
-            return getColumn(outputAlias.at(column));
+        inline ValueHandler getColumn(const StringRef column) {
+            return getColumn(outputIndex(column));
+        }
+
+        /**
+         *  Reads the column named by a ColumnKey, found by comparing hashes
+         *  instead of names. Otherwise the same as the getters taking an
+         *  alias.
+         *
+         *  Useage:     using namespace SQLiter::literals;
+         *              while (stmt.step())
+         *                  total += stmt.getDouble("price"_col);
+         *
+         *  @param column - ColumnKey naming the column
+         */
+        inline int getType(const ColumnKey column) {
+            return getType(outputIndex(column));
+        }
+
+        inline int getSize(const ColumnKey column) {
+            return getSize(outputIndex(column));
+        }
+
+        inline std::string getString(const ColumnKey column) {
+            return getString(outputIndex(column));
+        }
+
+        inline int getInt(const ColumnKey column) {
+            return getInt(outputIndex(column));
+        }
+
+        inline sqlite3_int64 getInt64(const ColumnKey column) {
+            return getInt64(outputIndex(column));
+        }
+
+        inline double getDouble(const ColumnKey column) {
+            return getDouble(outputIndex(column));
+        }
+
+        inline const void *getBlob(const ColumnKey column) {
+            return getBlob(outputIndex(column));
+        }
+
+        inline TextView getStringView(const ColumnKey column) {
+            return getStringView(outputIndex(column));
+        }
+
+        inline BlobView getBytes(const ColumnKey column) {
+            return getBytes(outputIndex(column));
+        }
+
+        inline ValueHandler getColumn(const ColumnKey column) {
+            return getColumn(outputIndex(column));
         }
 
         /**
@@ -423,8 +859,128 @@ namespace SQLiter {
          */
         void reset();
 
+        /**
+         *  Sets the executor used by stepAsync() and rowsAsync() when none is
+         *  given.
+         *
+         *  @param exec - Executor to step the statement and resume
+         *      coroutines on, or nullptr to require one on every call
+         */
+        void setExecutor(Executor *exec);
+
+        /**
+         *  Steps the prepared statement on the default executor, resuming the
+         *  awaiting coroutine on the executor once the step is done.
+         *
+         *  Useage:     bool row = co_await stmt->stepAsync();
+         *
+         *  @return - Awaitable yielding the same result as step()
+         */
+        StepAwaitable stepAsync();
+
+        /**
+         *  Steps the prepared statement on the given executor, resuming the
+         *  awaiting coroutine on the executor once the step is done.
+         *
+         *  @param exec - Executor to step the statement and resume on
+         *
+         *  @return - Awaitable yielding the same result as step()
+         */
+        StepAwaitable stepAsync(Executor &exec);
+
+        /**
+         *  Returns an asynchronous cursor over the rows of the statement using
+         *  the default executor.
+         *
+         *  @return - AsyncRows positioned before the first row
+         */
+        AsyncRows rowsAsync();
+
+        /**
+         *  Returns an asynchronous cursor over the rows of the statement using
+         *  the given executor.
+         *
+         *  @param exec - Executor to step the statement and resume on
+         *
+         *  @return - AsyncRows positioned before the first row
+         */
+        AsyncRows rowsAsync(Executor &exec);
+
+        /**
+         *  Returns a lazy range over the rows of the statement, for use with
+         *  range based for loops and standard algorithms. The statement is
+         *  stepped as the range is iterated and reset when the range is
+         *  destroyed.
+         *
+         *  Useage:     for (auto row : stmt->rows())
+         *                  std::cout << row.getStringView(0).str();
+         *
+         *  @return - RowRange positioned before the first row
+         */
+        RowRange rows();
+
+        /**
+         *  Returns a view of the current row whose getters check column types
+         *  as Policy says: Checked always, Unchecked never and DebugChecked
+         *  only in debug builds. Lets a hot loop drop the extra
+         *  sqlite3_column_type call of the checked getters, and switching the
+         *  policy at a call site changes nothing else. See ColumnAccess.
+         *
+         *  Useage:     auto cols = stmt->access<DebugChecked>();
+         *              while (stmt->step())
+         *                  sum += cols.getInt64(0);
+         *
+         *  @return - ColumnAccess reading this statement
+         */
+        template <class Policy>
+        inline ColumnAccess<Policy> access() {
+            return ColumnAccess<Policy>(this, &rowGeneration);
+        }
+
+        /**
+         *  Returns a view of the current row whose getters never check column
+         *  types. Same as access<Unchecked>().
+         *
+         *  @return - ColumnAccess reading this statement
+         */
+        ColumnAccess<Unchecked> unchecked();
+
+        /**
+         *  Steps the statement up to maxRows times, copying the rows into a
+         *  batch stored column by column. Rows are taken from after the
+         *  current one, so repeated calls read the results a block at a time.
+         *  Once the results run out further calls return no rows until the
+         *  statement is reset. Memory grows with the rows actually read, so
+         *  a maxRows of (size_t)-1 reads all remaining rows.
+         *
+         *  Useage:     ColumnBatch batch;
+         *              while (stmt->fetchColumnar(batch, 4096) > 0)
+         *                  sum(batch[0].doubleData(), batch.rowCount());
+         *
+         *  @param batch - Batch to fill, reusing the memory it already holds
+         *  @param maxRows - Largest number of rows to read
+         *
+         *  @return - Number of rows read, 0 once the results have run out
+         */
+        size_t fetchColumnar(ColumnBatch &batch, const size_t maxRows);
+
+        /**
+         *  Steps the statement up to maxRows times, copying the rows into a
+         *  new batch stored column by column.
+         *
+         *  @param maxRows - Largest number of rows to read
+         *
+         *  @return - ColumnBatch holding the rows read
+         */
+        inline ColumnBatch fetchColumnar(const size_t maxRows) {
+            ColumnBatch batch;
+            fetchColumnar(batch, maxRows);
+            return batch;
+        }
+
         /**
          *  Clears the bindings of a prepared statement by setting them to null.
+         *  Also releases any strings or blobs moved in by bind.
          *  Not necissary but useful if some fields can/should be null.
          *  The SQLite documentation made special mention of the fact that to 
          *  reset and to clear bindings are different functions in their entirety.
@@ -439,6 +995,26 @@ namespace SQLiter {
          */
         const int columnCount();
 
+        /**
+         *  Function for counting the number of variables the prepared
+         *  statement takes.
+         *
+         *  @return - largest variable index used by the statement
+         */
+        int parameterCount();
+
+        /**
+         *  Returns the underlying SQLite3 statement, for code that needs to
+         *  call the C interface directly. Ownership stays with the
+         *  StatementHandler.
+         *
+         *  @return - Pointer to the prepared statement, nullptr if preparing
+         *      it failed
+         */
+        inline sqlite3_stmt *getHandle() const {
+            return stmt.get();
+        }
+
         /**
          *  Returns the name of the database the statement column is from.
          *
@@ -471,6 +1047,16 @@ namespace SQLiter {
          */
         const std::string columnName(const int col);
 
+        /**
+         *  Returns the name SQLite gives the result column, which is the AS
+         *      alias of the column if one was given in the statement.
+         *
+         *  @param - Integer representing column to lookup
+         *
+         *  @return - String containing the result column name.
+         */
+        const std::string resultName(const int col);
+
         /**
          *  Returns the name of the database the statement column is from
          *
@@ -479,8 +1065,8 @@ namespace SQLiter {
          *  @return - Pointer to null terminated C String containing database
          *      name.
          */
-        inline const std::string databaseName(const std::string col) {
-            return databaseName(outputAlias.at(col));
+        inline const std::string databaseName(const StringRef col) {
+            return databaseName(outputIndex(col));
         }
 
         /**
@@ -491,8 +1077,8 @@ namespace SQLiter {
          *  @return - Pointer to null terminated C String containing name of
          *      the table.
          */
-        inline const std::string tableName(const std::string col) {
-            return tableName(outputAlias.at(col));
+        inline const std::string tableName(const StringRef col) {
+            return tableName(outputIndex(col));
         }
 
         /**
@@ -505,28 +1091,166 @@ namespace SQLiter {
          *  @return - Pointer to null terminated C String containing column
          *      name.
          */
-        inline const std::string columnName(const std::string col) {
-            return columnName(outputAlias.at(col));
+        inline const std::string columnName(const StringRef col) {
+            return columnName(outputIndex(col));
         }
 
         /**
-         *  Binds an input column to an alias.
+         *  Binds an input column to an alias. Named variables (:name, @name
+         *  and $name) are registered when the statement is prepared, both as
+         *  written and without their prefix, so this is only needed for other
+         *  aliases. An alias given with a prefix is registered in both forms
+         *  too. An alias that is already registered, by hand or from the
+         *  statement, is moved to the given column.
          *
          *  @param alias - C String to be used as the alias to the input
          *      column
          *  @param colNum - Integer representing the input column to bind to
          *      the alias
          */
-        void setInputAlias(const std::string alias, const int colNum);
+        void setInputAlias(const StringRef alias, const int colNum);
 
         /**
-         *  Binds an output column to an alias.
+         *  Binds an output column to an alias. Result columns are registered
+         *  under the names returned by sqlite3_column_name when the statement
+         *  is prepared, so this is only needed for other aliases, or to pick
+         *  one of several columns sharing a name. An alias that is already
+         *  registered, by hand or from the statement, is moved to the given
+         *  column.
          *
          *  @param alias - C String to be used as the alias to the input
          *      column
          *  @param colNum - Integer representing the output column to bind to
          *      the alias
          */
-        void setOutputAlias(const std::string alias, const int colNum);
+        void setOutputAlias(const StringRef alias, const int colNum);
+
+        /**
+         *  Returns the input column bound to an alias. The alias is searched
+         *  for without being copied. A named variable is found by its full
+         *  name, such as ":name", or by its bare name, "name", as long as no
+         *  other variable (such as "@name") shares the bare name.
+         *
+         *  @param alias - Alias of the input column
+         *
+         *  @return - Integer representing the input column
+         */
+        inline int inputIndex(const StringRef alias) const {
+            return checkedInput(inputAlias.find(alias));
+        }
+
+        /**
+         *  Returns the output column bound to an alias. The alias is searched
+         *  for without being copied. A name shared by several result columns
+         *  is ambiguous until setOutputAlias picks one.
+         *
+         *  @param alias - Alias of the output column
+         *
+         *  @return - Integer representing the output column
+         */
+        inline int outputIndex(const StringRef alias) const {
+            return checkedOutput(outputAlias.find(alias));
+        }
+
+        /**
+         *  Returns the input column named by a ColumnKey, comparing hashes
+         *  instead of names. See inputIndex(const StringRef).
+         *
+         *  @param key - ColumnKey naming the input column
+         *
+         *  @return - Integer representing the input column
+         */
+        inline int inputIndex(const ColumnKey key) const {
+            return checkedInput(inputAlias.find(key));
+        }
+
+        /**
+         *  Returns the output column named by a ColumnKey, comparing hashes
+         *  instead of names.
+         *
+         *  @param key - ColumnKey naming the output column
+         *
+         *  @return - Integer representing the output column
+         */
+        inline int outputIndex(const ColumnKey key) const {
+            return checkedOutput(outputAlias.find(key));
+        }
+
+    private:
+
+        /**
+         *  Drops the :, @ or $ that starts a named variable.
+         *
+         *  @param name - Name of the variable, with or without its prefix
+         *
+         *  @return - Name without its prefix
+         */
+        static inline StringRef stripPrefix(const StringRef name) {
+            if (!name.empty() && (name.data()[0] == ':' || name.data()[0] == '@' ||
+                name.data()[0] == '$'))
+                return StringRef(name.data() + 1, name.size() - 1);
+            return name;
+        }
+
+        /**
+         *  Returns the input column found by an inputAlias lookup, throwing
+         *  std::out_of_range if the alias is missing or ambiguous.
+         *
+         *  @param found - Result of looking up the alias
+         *
+         *  @return - Integer representing the input column
+         */
+        static inline int checkedInput(const int *found) {
+            if (found == nullptr)
+                throw std::out_of_range("No Such Input Alias");
+            if (*found == ambiguousAlias)
+                throw std::out_of_range("Ambiguous Input Alias");
+            return *found;
+        }
+
+        /**
+         *  Returns the output column found by an outputAlias lookup, throwing
+         *  std::out_of_range if the alias is missing or ambiguous.
+         *
+         *  @param found - Result of looking up the alias
+         *
+         *  @return - Integer representing the output column
+         */
+        static inline int checkedOutput(const int *found) {
+            if (found == nullptr)
+                throw std::out_of_range("No Such Output Alias");
+            if (*found == ambiguousAlias)
+                throw std::out_of_range("Ambiguous Output Alias");
+            return *found;
+        }
+
+        /**
+         *  Registers the named variables and the result column names of the
+         *  statement as input and output aliases, so they can be used without
+         *  calling setInputAlias or setOutputAlias. A bare variable name
+         *  shared by several named variables, or a name shared by several
+         *  result columns, is registered as ambiguous.
+         */
+        void resolveNames();
+
+        /**
+         *  Ends the recursion of bindFrom once every value has been bound.
+         */
+        inline void bindFrom(const int) {}
+
+        /**
+         *  Binds the first value to the given variable and recurses on the
+         *  remaining values with the next variable.
+         */
+        template <class T, class... Rest>
+        inline void bindFrom(const int var, const T &first, const Rest &... rest) {
+            bind(var, first);
+            bindFrom(var + 1, rest...);
+        }
     };
-}
\ No newline at end of file
+}
+
+#include "RowRange.h"
+#include "AccessPolicy.h"
+
+#endif
\ No newline at end of file
@@ -0,0 +1,133 @@
+/**
+ *  StepAwaitable.h
+ *  Provides awaitable objects that step a StatementHandler on an Executor,
+ *  for use with C++20 coroutines
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_STEPAWAITABLE_H
+#define SQLITER_STEPAWAITABLE_H
+
+#include <functional>
+#include "ThreadPool.h"
+
+namespace SQLiter {
+
+    class StatementHandler;
+
+    /**
+     *  Awaitable returned by StatementHandler::stepAsync.
+     *
+     *  co_await on it suspends the coroutine, steps the statement on the
+     *  executor and resumes the coroutine on the executor's thread, yielding
+     *  the same result step() would have. The type only relies on the
+     *  await_ready/await_suspend/await_resume protocol, so it compiles as
+     *  C++11 and works with any coroutine type when compiled as C++20.
+     *
+     *  Useage:     while (co_await stmt->stepAsync(pool))
+     *                  total += stmt->getInt(0);
+     */
+    class StepAwaitable {
+    private:
+        StatementHandler *stmt;
+        Executor *executor;
+        bool resetAtEnd;
+        bool row;
+
+        /**
+         *  Posts the step to the executor, calling resume once it is done.
+         *
+         *  @param resume - Function resuming the suspended coroutine
+         */
+        void schedule(std::function<void()> resume);
+
+    public:
+
+        /**
+         *  Constructor used by StatementHandler and AsyncRows.
+         *
+         *  @param statement - Statement to step
+         *  @param exec - Executor to step the statement and resume on
+         *  @param reset - Whether to reset the statement once it is done
+         *
+         *  @return - StepAwaitable ready to be awaited
+         */
+        StepAwaitable(StatementHandler *statement, Executor *exec, const bool reset) :
+            stmt(statement), executor(exec), resetAtEnd(reset), row(false) {};
+
+        /**
+         *  Always suspends, as stepping may block on disk.
+         */
+        inline bool await_ready() const {
+            return false;
+        }
+
+        /**
+         *  Hands the step to the executor.
+         *
+         *  @param handle - Handle of the suspended coroutine
+         */
+        template <class Handle>
+        inline void await_suspend(Handle handle) {
+            schedule([handle]() mutable { handle.resume(); });
+        }
+
+        /**
+         *  Returns the result of the step.
+         *
+         *  @return - True if the step returned a row
+         */
+        inline bool await_resume() const {
+            return row;
+        }
+    };
+
+    /**
+     *  Asynchronous cursor over the rows of a statement, returned by
+     *  StatementHandler::rowsAsync. Each co_await of next() steps the
+     *  statement on the executor. The statement is reset once it runs out of
+     *  rows so it is ready to be run again.
+     *
+     *  Useage:     auto rows = stmt->rowsAsync(pool);
+     *              while (co_await rows.next())
+     *                  std::cout << rows->getString(0);
+     */
+    class AsyncRows {
+    private:
+        StatementHandler *stmt;
+        Executor *executor;
+    public:
+
+        /**
+         *  Constructor used by StatementHandler.
+         *
+         *  @param statement - Statement to read the rows of
+         *  @param exec - Executor to step the statement and resume on
+         *
+         *  @return - AsyncRows positioned before the first row
+         */
+        AsyncRows(StatementHandler *statement, Executor *exec) :
+            stmt(statement), executor(exec) {};
+
+        /**
+         *  Advances to the next row.
+         *
+         *  @return - Awaitable yielding true while there is a current row
+         */
+        inline StepAwaitable next() {
+            return StepAwaitable(stmt, executor, true);
+        }
+
+        /**
+         *  Gives access to the statement to read the current row.
+         *
+         *  @return - Pointer to the statement
+         */
+        inline StatementHandler *operator->() const {
+            return stmt;
+        }
+    };
+}
+
+#endif
\ No newline at end of file
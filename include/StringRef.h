@@ -0,0 +1,146 @@
+/**
+ *  StringRef.h
+ *  Provides a non-owning reference to a run of characters, used to pass
+ *  strings through the library without copying them
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_STRINGREF_H
+#define SQLITER_STRINGREF_H
+
+#include <cstring>
+#include <string>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+namespace SQLiter {
+
+    /**
+     *  Pointer and length pair referring to characters owned by someone else,
+     *  filling the role of C++17's std::string_view for a C++11 library.
+     *
+     *  Implicitly constructible from C strings, std::string and, when
+     *  compiled as C++17, std::string_view, so functions taking a StringRef
+     *  accept any of them without allocating. The characters are not
+     *  guaranteed to be null terminated.
+     */
+    class StringRef {
+    private:
+        const char *ptr;
+        size_t len;
+    public:
+
+        /**
+         *  Default constructor creates an empty reference.
+         */
+        StringRef() : ptr(""), len(0) {};
+
+        /**
+         *  Constructor references a null terminated C string.
+         *
+         *  @param str - Pointer to null terminated C string, nullptr is
+         *      treated as an empty string
+         */
+        StringRef(const char *str) : ptr(str != nullptr ? str : ""),
+            len(str != nullptr ? strlen(str) : 0) {};
+
+        /**
+         *  Constructor references a run of characters of known length.
+         *
+         *  @param str - Pointer to the first character
+         *  @param size - Number of characters
+         */
+        StringRef(const char *str, const size_t size) : ptr(str), len(size) {};
+
+        /**
+         *  Constructor references the characters of a std::string.
+         *
+         *  @param str - String to reference, which must outlive the reference
+         */
+        StringRef(const std::string &str) : ptr(str.data()), len(str.size()) {};
+
+#if __cplusplus >= 201703L
+        /**
+         *  Constructor references the characters of a std::string_view.
+         *
+         *  @param str - View to reference
+         */
+        StringRef(const std::string_view str) : ptr(str.data()), len(str.size()) {};
+
+        /**
+         *  Converts the reference to a std::string_view.
+         */
+        inline operator std::string_view() const {
+            return std::string_view(ptr, len);
+        }
+#endif
+
+        /**
+         *  Returns a pointer to the first character.
+         *
+         *  @return - Pointer to the characters, not necessarily null terminated
+         */
+        inline const char *data() const {
+            return ptr;
+        }
+
+        /**
+         *  Returns the number of characters referenced.
+         *
+         *  @return - Number of characters
+         */
+        inline size_t size() const {
+            return len;
+        }
+
+        /**
+         *  Returns whether the reference is empty.
+         *
+         *  @return - True if no characters are referenced
+         */
+        inline bool empty() const {
+            return len == 0;
+        }
+
+        /**
+         *  Copies the referenced characters into a std::string.
+         *
+         *  @return - std::string holding a copy of the characters
+         */
+        inline std::string str() const {
+            return std::string(ptr, len);
+        }
+
+        /**
+         *  Returns a 64 bit FNV-1a hash of the referenced characters.
+         *
+         *  @return - Hash of the characters
+         */
+        inline unsigned long long hash() const {
+            unsigned long long h = 14695981039346656037ULL;
+            for (size_t i = 0; i < len; i++) {
+                h ^= (unsigned char)ptr[i];
+                h *= 1099511628211ULL;
+            }
+            return h;
+        }
+
+        /**
+         *  Compares the referenced characters with another reference.
+         */
+        inline bool operator==(const StringRef &o) const {
+            return len == o.len && (len == 0 || memcmp(ptr, o.ptr, len) == 0);
+        }
+
+        /**
+         *  Compares the referenced characters with another reference.
+         */
+        inline bool operator!=(const StringRef &o) const {
+            return !(*this == o);
+        }
+    };
+}
+
+#endif
\ No newline at end of file
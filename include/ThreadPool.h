@@ -0,0 +1,103 @@
+/**
+ *  ThreadPool.h
+ *  Provides a minimal executor interface and a fixed size pool of threads
+ *  implementing it
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_THREADPOOL_H
+#define SQLITER_THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SQLiter {
+
+    /**
+     *  Interface for anything able to run a task at some later point,
+     *  typically on another thread. Implement it to have the library hand
+     *  work to an existing event loop or thread pool.
+     */
+    class Executor {
+    public:
+        virtual ~Executor() {};
+
+        /**
+         *  Schedules a task to be run.
+         *
+         *  @param task - Function to run. Must not throw.
+         */
+        virtual void post(std::function<void()> task) = 0;
+    };
+
+    /**
+     *  Executor running tasks in order of submission on a fixed number of
+     *  threads.
+     */
+    class ThreadPool : public Executor {
+    private:
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> tasks;
+        std::mutex lock;
+        std::condition_variable available;
+        bool stopping;
+
+        /**
+         *  Body of every worker thread.
+         */
+        void loop();
+
+    public:
+
+        /**
+         *  Constructor starts the given number of threads.
+         *
+         *  @param threads - Number of threads to start, at least 1
+         *
+         *  @return - ThreadPool ready to accept tasks
+         */
+        ThreadPool(const unsigned threads);
+
+        /**
+         *  Destructor runs every task that is still queued, then stops and
+         *  joins the threads.
+         */
+        ~ThreadPool();
+
+        /**
+         *  Explicitely deletes the copy constructor as the pool owns running
+         *  threads.
+         */
+        ThreadPool(ThreadPool const &) = delete;
+
+        /**
+         *  Explicitely deletes the copy assignment operator as the pool owns
+         *  running threads.
+         */
+        ThreadPool &operator=(ThreadPool const &) = delete;
+
+        /**
+         *  Queues a task to be run by the next free thread. Exceptions thrown
+         *  by the task are discarded.
+         *
+         *  @param task - Function to run
+         */
+        void post(std::function<void()> task);
+
+        /**
+         *  Returns the number of threads in the pool.
+         *
+         *  @return - Number of threads
+         */
+        inline unsigned size() const {
+            return (unsigned)workers.size();
+        }
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,155 @@
+/**
+ *  TypedStatement.h
+ *  Provides a prepared statement whose parameter and column types are fixed
+ *  at compile time
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_TYPEDSTATEMENT_H
+#define SQLITER_TYPEDSTATEMENT_H
+
+#include <sqlite3.h>
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include "Codec.h"
+#include "StatementHandler.h"
+#include "SQLiteException.h"
+
+namespace SQLiter {
+
+    /**
+     *  List of indices used to expand tuples and parameter packs, filling the
+     *  role of C++14's std::index_sequence.
+     */
+    template <size_t... Is>
+    struct IndexList {};
+
+    template <size_t N, size_t... Is>
+    struct MakeIndexList : MakeIndexList<N - 1, N - 1, Is...> {};
+
+    template <size_t... Is>
+    struct MakeIndexList<0, Is...> {
+        typedef IndexList<Is...> type;
+    };
+
+    /**
+     *  Prepared statement with its parameter and column types given as a
+     *  function type, Row(Args...), where Row is a std::tuple of the column
+     *  types.
+     *
+     *  Binding and reading are resolved at compile time through Codec.
+     *  The statement's parameter and column counts are checked once when the
+     *  TypedStatement is created, so reading a row skips the per column
+     *  getType() check the StatementHandler getters make.
+     *
+     *  The TypedStatement does not own the StatementHandler it wraps, which
+     *  must outlive it.
+     *
+     *  Useage:     TypedStatement<std::tuple<int64_t, std::string>(int64_t)>
+     *                  byId(db.getStatement(id));
+     *              byId.bind(42);
+     *              while (byId.step())
+     *                  std::string name = std::get<1>(byId.row());
+     *              byId.reset();
+     */
+    template <class Signature>
+    class TypedStatement;
+
+    template <class... Cols, class... Args>
+    class TypedStatement<std::tuple<Cols...>(Args...)> {
+    public:
+        typedef std::tuple<Cols...> Row;
+
+    private:
+        StatementHandler *stmt;
+        sqlite3_stmt *handle;
+
+        template <size_t... Is>
+        inline void bindValues(IndexList<Is...>, const Args &... args) {
+            const int results[] = { SQLITE_OK, Codec<typename std::decay<Args>::type>::bind(
+                handle, (int)Is + 1, args)... };
+            for (size_t i = 0; i < sizeof(results) / sizeof(results[0]); i++) {
+                if (results[i] != SQLITE_OK)
+                    throw SQLiteException(sqlite3_errmsg(sqlite3_db_handle(handle)));
+            }
+        }
+
+        template <size_t... Is>
+        inline Row readRow(IndexList<Is...>) const {
+            return Row(Codec<Cols>::read(handle, (int)Is)...);
+        }
+
+    public:
+
+        /**
+         *  Constructor wraps a prepared statement, checking that it takes as
+         *  many variables as there are Args and returns as many columns as
+         *  there are Cols.
+         *
+         *  @param statement - Statement to wrap
+         *
+         *  @return - TypedStatement ready to be bound
+         */
+        TypedStatement(StatementHandler *statement) :
+            stmt(statement), handle(statement != nullptr ? statement->getHandle() : nullptr) {
+            if (handle == nullptr)
+                throw SQLiteException("Statement Is Not Prepared");
+            if (sqlite3_bind_parameter_count(handle) != (int)sizeof...(Args))
+                throw SQLiteException("Parameter Count Does Not Match Statement");
+            if (sqlite3_column_count(handle) != (int)sizeof...(Cols))
+                throw SQLiteException("Column Count Does Not Match Statement");
+        }
+
+        /**
+         *  Binds every variable of the statement in a single call.
+         *
+         *  @param args - Values to bind to variables 1 through sizeof...(Args)
+         */
+        inline void bind(const Args &... args) {
+            bindValues(typename MakeIndexList<sizeof...(Args)>::type(), args...);
+        }
+
+        /**
+         *  Steps the statement a single time.
+         *
+         *  @return - True if a row is available to read with row()
+         */
+        inline bool step() {
+            return stmt->step();
+        }
+
+        /**
+         *  Reads every column of the current row into a tuple, without
+         *  checking the column types.
+         *
+         *  *RESULTS ARE UNDEFINED IF A ROW WAS NOT RETURNED*
+         *
+         *  @return - Tuple holding the columns of the current row
+         */
+        inline Row row() const {
+            return readRow(typename MakeIndexList<sizeof...(Cols)>::type());
+        }
+
+        /**
+         *  Resets the statement so it is ready to be executed again. Bindings
+         *  are kept.
+         */
+        inline void reset() {
+            stmt->reset();
+        }
+
+        /**
+         *  Gives access to the wrapped statement.
+         *
+         *  @return - Pointer to the StatementHandler
+         */
+        inline StatementHandler *operator->() const {
+            return stmt;
+        }
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,309 @@
+/**
+ *  UserFunction.h
+ *  Provides the glue between SQLite3's function callbacks and C++ callables
+ *  and classes, decoding arguments and encoding results through Codec
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_USERFUNCTION_H
+#define SQLITER_USERFUNCTION_H
+
+#include <sqlite3.h>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include "Codec.h"
+#include "TypedStatement.h"
+
+namespace SQLiter {
+
+    /**
+     *  Result and argument types of a function type, function pointer,
+     *  member function pointer or class with a single non-template
+     *  operator(), such as a lambda. Generic lambdas cannot be described.
+     */
+    template <class F>
+    struct FunctionTraits : FunctionTraits<decltype(&F::operator())> {};
+
+    template <class R, class... Args>
+    struct FunctionTraits<R(Args...)> {
+        typedef R Result;
+        typedef std::tuple<typename std::decay<Args>::type...> Arguments;
+        static const size_t arity = sizeof...(Args);
+    };
+
+    template <class R, class... Args>
+    struct FunctionTraits<R(*)(Args...)> : FunctionTraits<R(Args...)> {};
+
+    template <class C, class R, class... Args>
+    struct FunctionTraits<R(C::*)(Args...)> : FunctionTraits<R(Args...)> {};
+
+    template <class C, class R, class... Args>
+    struct FunctionTraits<R(C::*)(Args...) const> : FunctionTraits<R(Args...)> {};
+
+    /**
+     *  Type of argument I of F, without references or const.
+     */
+    template <class F, size_t I>
+    struct ArgumentType {
+        typedef typename std::tuple_element<I, typename FunctionTraits<F>::Arguments>::type type;
+    };
+
+    /**
+     *  Calls a callable with the values of an SQL function call decoded by
+     *  the Codec of each argument type, and sets the function's result from
+     *  what it returns. A void callable returns NULL to SQL.
+     */
+    template <class F, size_t... Is>
+    inline void callWithValues(F &func, sqlite3_context *context, sqlite3_value **values,
+        IndexList<Is...>, std::true_type) {
+        (void)values;
+        func(Codec<typename ArgumentType<F, Is>::type>::read(values[Is])...);
+        sqlite3_result_null(context);
+    }
+
+    template <class F, size_t... Is>
+    inline void callWithValues(F &func, sqlite3_context *context, sqlite3_value **values,
+        IndexList<Is...>, std::false_type) {
+        (void)values;
+        typedef typename std::decay<typename FunctionTraits<F>::Result>::type Result;
+        Codec<Result>::result(context, func(Codec<typename ArgumentType<F, Is>::type>::read(values[Is])...));
+    }
+
+    template <class F>
+    inline void callWithValues(F &func, sqlite3_context *context, sqlite3_value **values) {
+        callWithValues(func, context, values,
+            typename MakeIndexList<FunctionTraits<F>::arity>::type(),
+            std::is_void<typename FunctionTraits<F>::Result>());
+    }
+
+    /**
+     *  Reports an exception escaping a user function to SQLite as the error
+     *  of the function call, so it surfaces from the statement that called
+     *  it instead of unwinding through SQLite's C frames. Must be called from
+     *  inside a catch block.
+     *
+     *  @param context - Context of the function call
+     */
+    inline void reportFunctionError(sqlite3_context *context) {
+        try {
+            throw;
+        } catch (const std::bad_alloc &) {
+            sqlite3_result_error_nomem(context);
+        } catch (const std::exception &e) {
+            sqlite3_result_error(context, e.what(), -1);
+        } catch (...) {
+            sqlite3_result_error(context, "Unknown Error In User Function", -1);
+        }
+    }
+
+    /**
+     *  Callbacks registering a callable of type F as a scalar SQL function.
+     *  The callable is copied onto the heap once, at registration, and
+     *  handed to SQLite as the function's user data.
+     */
+    template <class F>
+    struct ScalarFunction {
+        static void call(sqlite3_context *context, int, sqlite3_value **values) {
+            try {
+                callWithValues(*(F*)sqlite3_user_data(context), context, values);
+            } catch (...) {
+                reportFunctionError(context);
+            }
+        }
+
+        static void destroy(void *func) {
+            delete (F*)func;
+        }
+    };
+
+    /**
+     *  Calls Agg::step with the values of an SQL function call decoded by
+     *  the Codec of each of its argument types.
+     */
+    template <class Agg, size_t... Is>
+    inline void stepWithValues(Agg &agg, sqlite3_value **values, IndexList<Is...>) {
+        (void)values;
+        agg.step(Codec<typename ArgumentType<decltype(&Agg::step), Is>::type>::read(values[Is])...);
+    }
+
+    /**
+     *  Calls Agg::inverse with the values of an SQL function call decoded by
+     *  the Codec of each of its argument types.
+     */
+    template <class Agg, size_t... Is>
+    inline void inverseWithValues(Agg &agg, sqlite3_value **values, IndexList<Is...>) {
+        (void)values;
+        agg.inverse(Codec<typename ArgumentType<decltype(&Agg::inverse), Is>::type>::read(values[Is])...);
+    }
+
+    /**
+     *  Sets the result of an SQL function call from Agg::final.
+     */
+    template <class Agg>
+    inline void resultOfFinal(Agg &agg, sqlite3_context *context) {
+        typedef typename std::decay<typename FunctionTraits<decltype(&Agg::final)>::Result>::type Result;
+        Codec<Result>::result(context, agg.final());
+    }
+
+    /**
+     *  Sets the result of an SQL function call from Agg::value.
+     */
+    template <class Agg>
+    inline void resultOfValue(Agg &agg, sqlite3_context *context) {
+        typedef typename std::decay<typename FunctionTraits<decltype(&Agg::value)>::Result>::type Result;
+        Codec<Result>::result(context, agg.value());
+    }
+
+    /**
+     *  Whether a class has a member named final.
+     */
+    template <class Agg>
+    struct HasFinal {
+    private:
+        template <class U>
+        static auto check(int) -> decltype(&U::final, std::true_type());
+
+        template <class U>
+        static std::false_type check(...);
+    public:
+        static const bool value = decltype(check<Agg>(0))::value;
+    };
+
+    template <class Agg>
+    inline void resultOfWindowFinal(Agg &agg, sqlite3_context *context, std::true_type) {
+        resultOfFinal(agg, context);
+    }
+
+    template <class Agg>
+    inline void resultOfWindowFinal(Agg &agg, sqlite3_context *context, std::false_type) {
+        resultOfValue(agg, context);
+    }
+
+    /**
+     *  Sets the result of the last call of a window function from
+     *  Agg::final, or Agg::value if Agg has no final.
+     */
+    template <class Agg>
+    inline void resultOfWindowFinal(Agg &agg, sqlite3_context *context) {
+        resultOfWindowFinal(agg, context, std::integral_constant<bool, HasFinal<Agg>::value>());
+    }
+
+    /**
+     *  Callbacks registering a class as an aggregate SQL function. The state
+     *  of each group is an Agg constructed in place inside the memory SQLite
+     *  allocates for the group with sqlite3_aggregate_context, and destroyed
+     *  in xFinal, so no group costs an allocation of its own. SQLite zeroes
+     *  that memory, which leaves constructed false until the first row.
+     */
+    template <class Agg>
+    struct AggregateFunction {
+        struct Slot {
+            typename std::aligned_storage<sizeof(Agg), std::alignment_of<Agg>::value>::type storage;
+            bool constructed;
+        };
+
+        static_assert(std::alignment_of<Agg>::value <= 8,
+            "Aggregate state must not need more than the 8 byte alignment of SQLite's allocator");
+
+        static inline Agg *state(Slot *slot) {
+            return reinterpret_cast<Agg*>(&slot->storage);
+        }
+
+        /**
+         *  Returns the state of the group, constructing it on first use, or
+         *  nullptr if SQLite is out of memory.
+         */
+        static inline Agg *current(sqlite3_context *context) {
+            Slot *slot = (Slot*)sqlite3_aggregate_context(context, (int)sizeof(Slot));
+            if (slot == nullptr)
+                return nullptr;
+            if (!slot->constructed) {
+                new (&slot->storage) Agg();
+                slot->constructed = true;
+            }
+            return state(slot);
+        }
+
+        /**
+         *  Sets the result of the function from the group's state, using a
+         *  value-initialized Agg, like the state built for a first row, if the
+         *  group had no rows, and destroys the state if asked to.
+         */
+        static void produce(sqlite3_context *context,
+            void(*result)(Agg &, sqlite3_context *), const bool destroy) {
+            // a size of 0 allocates nothing for a group that had no rows
+            Slot *slot = (Slot*)sqlite3_aggregate_context(context, 0);
+            try {
+                if (slot != nullptr && slot->constructed) {
+                    result(*state(slot), context);
+                } else {
+                    Agg empty = Agg();
+                    result(empty, context);
+                }
+            } catch (...) {
+                reportFunctionError(context);
+            }
+            if (destroy && slot != nullptr && slot->constructed) {
+                state(slot)->~Agg();
+                slot->constructed = false;
+            }
+        }
+
+        static void step(sqlite3_context *context, int, sqlite3_value **values) {
+            try {
+                Agg *agg = current(context);
+                if (agg == nullptr) {
+                    sqlite3_result_error_nomem(context);
+                    return;
+                }
+                stepWithValues(*agg, values,
+                    typename MakeIndexList<FunctionTraits<decltype(&Agg::step)>::arity>::type());
+            } catch (...) {
+                reportFunctionError(context);
+            }
+        }
+
+        static void final(sqlite3_context *context) {
+            produce(context, &resultOfFinal<Agg>, true);
+        }
+    };
+
+    /**
+     *  Callbacks registering a class as an aggregate window function. Adds
+     *  xInverse, which removes a row leaving the window frame, and xValue,
+     *  which gives the result for the current frame without ending the
+     *  group, to the callbacks of AggregateFunction.
+     */
+    template <class Agg>
+    struct WindowFunction : AggregateFunction<Agg> {
+        typedef AggregateFunction<Agg> Base;
+
+        static void inverse(sqlite3_context *context, int, sqlite3_value **values) {
+            try {
+                Agg *agg = Base::current(context);
+                if (agg == nullptr) {
+                    sqlite3_result_error_nomem(context);
+                    return;
+                }
+                inverseWithValues(*agg, values,
+                    typename MakeIndexList<FunctionTraits<decltype(&Agg::inverse)>::arity>::type());
+            } catch (...) {
+                reportFunctionError(context);
+            }
+        }
+
+        static void value(sqlite3_context *context) {
+            Base::produce(context, &resultOfValue<Agg>, false);
+        }
+
+        static void final(sqlite3_context *context) {
+            Base::produce(context, &resultOfWindowFinal<Agg>, true);
+        }
+    };
+}
+
+#endif
\ No newline at end of file
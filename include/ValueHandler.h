@@ -7,7 +7,11 @@
  *  @author William Horstkamp
  */
 
+#ifndef SQLITER_VALUEHANDLER_H
+#define SQLITER_VALUEHANDLER_H
+
 #include <sqlite3.h>
+#include "Codec.h"
 
 namespace SQLiter {
 
@@ -89,5 +93,22 @@ namespace SQLiter {
             return (const char*)sqlite3_column_text(stmt, colNum);
         }
 
+        /**
+         *  Reads the value as any type with a Codec, including types of your
+         *  own, decoded straight from the column without going through the
+         *  conversion operators. Like them it does not check the column type.
+         *
+         *  Useage:     Uuid owner = stmt->getColumn(0).as<Uuid>();
+         *              std::string name = stmt->getColumn(1).as<std::string>();
+         *
+         *  @return - Value of the column decoded by Codec<T>
+         */
+        template <class T>
+        inline T as() const {
+            return Codec<T>::read(stmt, colNum);
+        }
+
     };
-}
\ No newline at end of file
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,259 @@
+/**
+ *  WriteExecutor.h
+ *  Provides a dedicated writer thread that batches write jobs submitted from
+ *  any thread into shared transactions
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_WRITEEXECUTOR_H
+#define SQLITER_WRITEEXECUTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "SQLiteHandler.h"
+
+namespace SQLiter {
+
+    /**
+     *  Class that owns a writer thread on top of an SQLiteHandler.
+     *
+     *  Jobs are pushed onto a lock-free multiple producer, single consumer
+     *  queue and the writer thread runs them in batches, each batch inside a
+     *  single transaction. This turns one commit (and one fsync) per write
+     *  into one commit per batch. A batch is closed when it holds maxBatch jobs
+     *  or when the queue has been empty for maxLatency since the batch began.
+     *
+     *  Every job runs inside its own savepoint, so a job that throws only rolls
+     *  back its own changes and the exception is handed to that job's future.
+     *  Results are only delivered once the batch has committed.
+     *
+     *  The SQLiteHandler must not be used by any other thread for as long as
+     *  the WriteExecutor exists.
+     */
+    class WriteExecutor {
+    public:
+
+        /**
+         *  Constructor starts the writer thread.
+         *
+         *  @param handler - Open database the writer thread writes to
+         *  @param maxBatch - Largest number of jobs committed in one transaction
+         *  @param maxLatency - Longest time a batch waits for further jobs
+         *      before it is committed
+         *
+         *  @return - WriteExecutor ready to accept jobs
+         */
+        WriteExecutor(SQLiteHandler &handler, const size_t maxBatch = 1000,
+            const std::chrono::milliseconds maxLatency = std::chrono::milliseconds(5));
+
+        /**
+         *  Destructor runs every job that is still queued, then stops and joins
+         *  the writer thread. A job pushed by a submit call racing with the
+         *  destructor is not run; its future holds an SQLiteException.
+         */
+        ~WriteExecutor();
+
+        /**
+         *  Explicitely deletes the copy constructor as the executor owns a
+         *  running thread.
+         */
+        WriteExecutor(WriteExecutor const &) = delete;
+
+        /**
+         *  Explicitely deletes the copy assignment operator as the executor
+         *  owns a running thread.
+         */
+        WriteExecutor &operator=(WriteExecutor const &) = delete;
+
+        /**
+         *  Queues a job to be run on the writer thread. May be called from any
+         *  thread.
+         *
+         *  Useage:     auto f = exec.submit([](SQLiteHandler &db) {
+         *                  return db.rawExec("DELETE FROM t");
+         *              });
+         *
+         *  @param job - Callable taking an SQLiteHandler & that performs the
+         *      write and returns the job's result
+         *
+         *  @return - Future that receives the job's result, or its exception,
+         *      once the batch containing the job has been committed
+         */
+        template <class F>
+        std::future<decltype(std::declval<F &>()(std::declval<SQLiteHandler &>()))> submit(F job) {
+            typedef decltype(std::declval<F &>()(std::declval<SQLiteHandler &>())) R;
+            std::unique_ptr<TypedJob<R>> node(new TypedJob<R>(std::move(job)));
+            std::future<R> res = node->promise.get_future();
+            enqueue(node.release());
+            return res;
+        }
+
+        /**
+         *  Queues a bind, step and reset of a statement that has already been
+         *  prepared on the executor's SQLiteHandler.
+         *
+         *  @param key - Key of the prepared statement to execute
+         *  @param args - Values to bind to the statement's variables, in order
+         *
+         *  @return - Future that receives the number of rows changed once the
+         *      batch containing the statement has been committed
+         */
+        template <class... Args>
+        std::future<int> execute(const std::string key, Args... args) {
+            return submit([=](SQLiteHandler &db) -> int {
+                StatementHandler *stmt = db.getStatement(key);
+                stmt->bindAll(args...);
+                const bool row = stmt->step();
+                const int resCode = row ? SQLITE_OK : db.errorCode();
+                stmt->reset();
+                db.result(resCode);
+                return db.changes();
+            });
+        }
+
+    private:
+
+        /**
+         *  Intrusive queue node
+         */
+        struct Node {
+            std::atomic<Node *> next;
+            Node() : next(nullptr) {};
+        };
+
+        /**
+         *  Type erased job. run() is called inside the batch's transaction,
+         *  finish() once the batch has committed or failed.
+         */
+        struct Job : Node {
+            std::exception_ptr error;
+            virtual ~Job() {};
+            virtual void run(SQLiteHandler &handler) = 0;
+            virtual void finish() = 0;
+        };
+
+        /**
+         *  Job returning a value of type R, which is held until the batch
+         *  commits.
+         */
+        template <class R>
+        struct TypedJob : Job {
+            std::function<R(SQLiteHandler &)> func;
+            std::promise<R> promise;
+            std::unique_ptr<R> value;
+
+            template <class F>
+            TypedJob(F &&f) : func(std::forward<F>(f)) {};
+
+            void run(SQLiteHandler &handler) {
+                value.reset(new R(func(handler)));
+            }
+
+            void finish() {
+                if (error)
+                    promise.set_exception(error);
+                else
+                    promise.set_value(std::move(*value));
+            }
+        };
+
+        SQLiteHandler &db;
+        const size_t batchSize;
+        const std::chrono::milliseconds latency;
+
+        /**
+         *  Producers swap themselves in at head, the writer thread pops from
+         *  tail. stub keeps the queue non-empty so neither side needs a lock.
+         */
+        std::atomic<Node *> head;
+        Node *tail;
+        Node stub;
+
+        std::atomic<bool> stopping;
+        std::atomic<bool> sleeping;
+
+        /**
+         *  Number of enqueue calls past their check of stopping, so the
+         *  destructor can wait for their pushes before draining the queue.
+         */
+        std::atomic<unsigned> producers;
+        std::mutex wakeLock;
+        std::condition_variable wake;
+        std::thread worker;
+
+        /**
+         *  Pushes a job onto the queue and wakes the writer thread if it is
+         *  asleep.
+         */
+        void enqueue(Job *job);
+
+        /**
+         *  Pushes a node onto the queue without waking the writer thread.
+         */
+        void push(Node *node);
+
+        /**
+         *  Pops a job from the queue, or returns nullptr if it is empty.
+         *  Only called by the writer thread.
+         */
+        Job *pop();
+
+        /**
+         *  Pops a job, sleeping until one arrives, the deadline passes or the
+         *  executor is stopped.
+         */
+        Job *waitForJob(const std::chrono::steady_clock::time_point deadline);
+
+        /**
+         *  Fails every job left in the queue once the writer thread is gone.
+         */
+        void failRemaining();
+
+        /**
+         *  Runs a job inside its own savepoint, recording any exception.
+         */
+        void runJob(Job *job);
+
+        /**
+         *  Body of the writer thread.
+         */
+        void loop();
+    };
+
+    /**
+     *  Job returning nothing
+     */
+    template <>
+    struct WriteExecutor::TypedJob<void> : WriteExecutor::Job {
+        std::function<void(SQLiteHandler &)> func;
+        std::promise<void> promise;
+
+        template <class F>
+        TypedJob(F &&f) : func(std::forward<F>(f)) {};
+
+        void run(SQLiteHandler &handler) {
+            func(handler);
+        }
+
+        void finish() {
+            if (error)
+                promise.set_exception(error);
+            else
+                promise.set_value();
+        }
+    };
+}
+
+#endif
\ No newline at end of file
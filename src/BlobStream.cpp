@@ -0,0 +1,142 @@
+/**
+ *  BlobStream.cpp
+ *  Provides incremental reading and writing of a single blob in the
+ *  database, without loading the whole blob into memory
+ *
+ *  @author William Horstkamp
+ */
+
+/**
+ *  SQLiter For C++11 is an SQLite3 wrapper with C++11 features.
+ *  Copyright (C) 2015 William Horstkamp
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a
+ *	copy of this software and associated documentation files (the "Software"),
+ *	to deal in the Software without restriction, including without limitation
+ *	the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *	and/or sell copies of the Software, and to permit persons to whom the
+ *	Software is furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in
+ *	all copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *	OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *	DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include "BlobStream.h"
+
+namespace SQLiter {
+
+    BlobStream::BlobStream(sqlite3 *connection, const std::string database, const std::string table,
+        const std::string column, const sqlite3_int64 row, const bool write,
+        const size_t chunkSize) :
+        db(connection), blob(nullptr), blobSize(0), writable(write), base(0),
+        buffer(std::max(chunkSize, (size_t)1)) {
+        if (sqlite3_blob_open(db, database.c_str(), table.c_str(), column.c_str(), row,
+            write ? 1 : 0, &blob) != SQLITE_OK) {
+            // a handle may be returned even on failure
+            sqlite3_blob_close(blob);
+            throw SQLiteException(sqlite3_errmsg(db));
+        }
+        blobSize = sqlite3_blob_bytes(blob);
+    }
+
+    BlobStream::~BlobStream() {
+        flush();
+        sqlite3_blob_close(blob);
+    }
+
+    int BlobStream::position() const {
+        if (eback() != nullptr)
+            return base + (int)(gptr() - eback());
+        if (pbase() != nullptr)
+            return base + (int)(pptr() - pbase());
+        return base;
+    }
+
+    int BlobStream::flush() {
+        int resCode = SQLITE_OK;
+        const int pending = pbase() != nullptr ? (int)(pptr() - pbase()) : 0;
+        const int cur = position();
+        if (pending > 0)
+            resCode = sqlite3_blob_write(blob, pbase(), pending, base);
+        base = cur;
+        setg(nullptr, nullptr, nullptr);
+        setp(nullptr, nullptr);
+        return resCode;
+    }
+
+    BlobStream::int_type BlobStream::underflow() {
+        if (gptr() != nullptr && gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+        if (flush() != SQLITE_OK || base >= blobSize)
+            return traits_type::eof();
+        const int count = std::min((int)buffer.size(), blobSize - base);
+        if (sqlite3_blob_read(blob, buffer.data(), count, base) != SQLITE_OK)
+            return traits_type::eof();
+        setg(buffer.data(), buffer.data(), buffer.data() + count);
+        return traits_type::to_int_type(*gptr());
+    }
+
+    BlobStream::int_type BlobStream::overflow(int_type c) {
+        if (!writable || flush() != SQLITE_OK || base >= blobSize)
+            return traits_type::eof();
+        const int count = std::min((int)buffer.size(), blobSize - base);
+        setp(buffer.data(), buffer.data() + count);
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int BlobStream::sync() {
+        return flush() == SQLITE_OK ? 0 : -1;
+    }
+
+    BlobStream::pos_type BlobStream::seekoff(off_type off, std::ios_base::seekdir dir,
+        std::ios_base::openmode) {
+        off_type target;
+        if (dir == std::ios_base::beg)
+            target = off;
+        else if (dir == std::ios_base::cur)
+            target = position() + off;
+        else
+            target = blobSize + off;
+        if (target < 0 || target > blobSize || flush() != SQLITE_OK)
+            return pos_type(off_type(-1));
+        base = (int)target;
+        return pos_type(target);
+    }
+
+    BlobStream::pos_type BlobStream::seekpos(pos_type pos, std::ios_base::openmode which) {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+
+    void BlobStream::read(void *out, const int count, const int offset) {
+        if (sqlite3_blob_read(blob, out, count, offset) != SQLITE_OK)
+            throw SQLiteException(sqlite3_errmsg(db));
+    }
+
+    void BlobStream::write(const void *in, const int count, const int offset) {
+        if (sqlite3_blob_write(blob, in, count, offset) != SQLITE_OK)
+            throw SQLiteException(sqlite3_errmsg(db));
+    }
+
+    void BlobStream::reopen(const sqlite3_int64 row) {
+        if (flush() != SQLITE_OK)
+            throw SQLiteException(sqlite3_errmsg(db));
+        if (sqlite3_blob_reopen(blob, row) != SQLITE_OK)
+            throw SQLiteException(sqlite3_errmsg(db));
+        blobSize = sqlite3_blob_bytes(blob);
+        base = 0;
+    }
+}
\ No newline at end of file
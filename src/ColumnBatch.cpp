@@ -0,0 +1,163 @@
+/**
+ *  ColumnBatch.cpp
+ *  Provides a block of result rows stored column by column in contiguous
+ *  typed arrays
+ *
+ *  @author William Horstkamp
+ */
+
+/**
+ *  SQLiter For C++11 is an SQLite3 wrapper with C++11 features.
+ *  Copyright (C) 2015 William Horstkamp
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a
+ *	copy of this software and associated documentation files (the "Software"),
+ *	to deal in the Software without restriction, including without limitation
+ *	the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *	and/or sell copies of the Software, and to permit persons to whom the
+ *	Software is furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in
+ *	all copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *	OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *	DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include <cctype>
+#include "ColumnBatch.h"
+
+namespace SQLiter {
+
+    const size_t ColumnData::initialRows;
+
+    /**
+     *  Maps the declared type of a column to a storage type using SQLite's
+     *  affinity rules.
+     *
+     *  @param decl - Declared type of the column, nullptr for expressions
+     *
+     *  @return - SQLite3 type code, SQLITE_NULL if the declared type does not
+     *      settle it
+     */
+    static int declaredType(const char *decl) {
+        if (decl == nullptr)
+            return SQLITE_NULL;
+        std::string upper(decl);
+        std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+        if (upper.find("INT") != std::string::npos)
+            return SQLITE_INTEGER;
+        if (upper.find("CHAR") != std::string::npos || upper.find("CLOB") != std::string::npos ||
+            upper.find("TEXT") != std::string::npos)
+            return SQLITE_TEXT;
+        if (upper.find("BLOB") != std::string::npos)
+            return SQLITE_BLOB;
+        if (upper.find("REAL") != std::string::npos || upper.find("FLOA") != std::string::npos ||
+            upper.find("DOUB") != std::string::npos)
+            return SQLITE_FLOAT;
+        return SQLITE_NULL;
+    }
+
+    void ColumnData::start(sqlite3_stmt *stmt, const int column, const size_t maxRows) {
+        const char *colName = sqlite3_column_name(stmt, column);
+        name = colName != nullptr ? colName : "";
+        rows = 0;
+        capacity = std::min(maxRows, initialRows);
+        ints.clear();
+        doubles.clear();
+        offsets.clear();
+        bytes.clear();
+        nulls.clear();
+        nulls.reserve((capacity + 7) / 8);
+        type = SQLITE_NULL;
+        const int storage = declaredType(sqlite3_column_decltype(stmt, column));
+        if (storage != SQLITE_NULL)
+            setType(storage);
+    }
+
+    void ColumnData::setType(const int storage) {
+        type = storage;
+        switch (type) {
+        case SQLITE_INTEGER:
+            ints.reserve(capacity);
+            ints.assign(rows, 0);
+            break;
+        case SQLITE_FLOAT:
+            doubles.reserve(capacity);
+            doubles.assign(rows, 0.0);
+            break;
+        default:
+            offsets.reserve(capacity + 1);
+            offsets.assign(rows + 1, 0);
+            break;
+        }
+    }
+
+    void ColumnData::append(sqlite3_stmt *stmt, const int column) {
+        const int valueType = sqlite3_column_type(stmt, column);
+        if (rows % 8 == 0)
+            nulls.push_back(0);
+        if (valueType == SQLITE_NULL) {
+            nulls[rows / 8] |= (unsigned char)(1 << (rows % 8));
+            switch (type) {
+            case SQLITE_INTEGER:
+                ints.push_back(0);
+                break;
+            case SQLITE_FLOAT:
+                doubles.push_back(0.0);
+                break;
+            case SQLITE_TEXT:
+            case SQLITE_BLOB:
+                offsets.push_back(bytes.size());
+                break;
+            }
+            rows++;
+            return;
+        }
+        if (type == SQLITE_NULL)
+            setType(valueType);
+        switch (type) {
+        case SQLITE_INTEGER:
+            ints.push_back(sqlite3_column_int64(stmt, column));
+            break;
+        case SQLITE_FLOAT:
+            doubles.push_back(sqlite3_column_double(stmt, column));
+            break;
+        case SQLITE_TEXT: {
+            const unsigned char *text = sqlite3_column_text(stmt, column);
+            bytes.insert(bytes.end(), text, text + sqlite3_column_bytes(stmt, column));
+            offsets.push_back(bytes.size());
+            break;
+        }
+        default: {
+            const unsigned char *blob = (const unsigned char*)sqlite3_column_blob(stmt, column);
+            const int size = sqlite3_column_bytes(stmt, column);
+            if (size > 0)
+                bytes.insert(bytes.end(), blob, blob + size);
+            offsets.push_back(bytes.size());
+            break;
+        }
+        }
+        rows++;
+    }
+
+    void ColumnBatch::start(sqlite3_stmt *stmt, const size_t maxRows) {
+        rows = 0;
+        columns.resize(sqlite3_column_count(stmt));
+        for (size_t i = 0; i < columns.size(); i++)
+            columns[i].start(stmt, (int)i, maxRows);
+    }
+
+    void ColumnBatch::append(sqlite3_stmt *stmt) {
+        for (size_t i = 0; i < columns.size(); i++)
+            columns[i].append(stmt, (int)i);
+        rows++;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,200 @@
+/**
+ *  ConnectionPool.cpp
+ *  Provides a pool of SQLiteHandler connections to a single database file,
+ *  split into a set of readers and a single writer
+ *
+ *  @author William Horstkamp
+ */
+
+/**
+ *  SQLiter For C++11 is an SQLite3 wrapper with C++11 features.
+ *  Copyright (C) 2015 William Horstkamp
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a
+ *	copy of this software and associated documentation files (the "Software"),
+ *	to deal in the Software without restriction, including without limitation
+ *	the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *	and/or sell copies of the Software, and to permit persons to whom the
+ *	Software is furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in
+ *	all copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *	OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *	DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include "ConnectionPool.h"
+
+namespace SQLiter {
+
+    ConnectionPool::Lease::~Lease() {
+        release();
+    }
+
+    ConnectionPool::Lease::Lease(Lease &&o) :
+        pool(o.pool), handler(o.handler), writer(o.writer) {
+        o.handler = nullptr;
+    }
+
+    ConnectionPool::Lease &ConnectionPool::Lease::operator=(Lease &&o) {
+        if (this != &o) {
+            release();
+            pool = o.pool;
+            handler = o.handler;
+            writer = o.writer;
+            o.handler = nullptr;
+        }
+        return *this;
+    }
+
+    void ConnectionPool::Lease::release() {
+        if (handler != nullptr) {
+            pool->giveBack(handler, writer);
+            handler = nullptr;
+        }
+    }
+
+    ConnectionPool::ConnectionPool(const std::string location, const unsigned numReaders,
+        const int busyMs, const bool useWal) : path(location), writerBusy(false) {
+        if (numReaders == 0)
+            throw SQLiteException("Pool Requires At Least One Reader");
+        writeConn.reset(new SQLiteHandler(location));
+        writeConn->busyTimeout(busyMs);
+        if (useWal)
+            writeConn->rawExec("PRAGMA journal_mode=WAL");
+        for (unsigned i = 0; i < numReaders; i++) {
+            std::unique_ptr<SQLiteHandler> conn(new SQLiteHandler(location));
+            conn->busyTimeout(busyMs);
+            conn->rawExec("PRAGMA query_only=1");
+            idleReaders.push_back(conn.get());
+            readers.push_back(std::move(conn));
+        }
+    }
+
+    ConnectionPool::~ConnectionPool() {
+        idleReaders.clear();
+        readers.clear();
+        writeConn.reset();
+    }
+
+    ConnectionPool::Lease ConnectionPool::reader() {
+        std::unique_lock<std::mutex> guard(lock);
+        available.wait(guard, [this] { return !idleReaders.empty(); });
+        SQLiteHandler *conn = idleReaders.back();
+        idleReaders.pop_back();
+        return Lease(this, conn, false);
+    }
+
+    ConnectionPool::Lease ConnectionPool::writer() {
+        std::unique_lock<std::mutex> guard(lock);
+        available.wait(guard, [this] { return !writerBusy; });
+        writerBusy = true;
+        return Lease(this, writeConn.get(), true);
+    }
+
+    void ConnectionPool::prepareStatement(const StringRef key, const StringRef stmtStr) {
+        forEachConnection([key, stmtStr](SQLiteHandler &conn) {
+            conn.prepareStatement(key, stmtStr);
+        });
+    }
+
+    void ConnectionPool::registerStatement(const StringRef key, const StringRef stmtStr) {
+        forEachConnection([key, stmtStr](SQLiteHandler &conn) {
+            conn.registerStatement(key, stmtStr);
+        });
+    }
+
+    size_t ConnectionPool::loadManifest(const std::string location) {
+        const std::string manifest = SQLiteHandler::readManifest(location);
+        size_t count = 0;
+        forEachConnection([&manifest, &count](SQLiteHandler &conn) {
+            count = conn.registerManifest(manifest);
+        });
+        return count;
+    }
+
+    std::future<void> ConnectionPool::warmUp() {
+        return std::async(std::launch::async, [this] {
+            std::vector<std::future<void>> tasks;
+            tasks.push_back(std::async(std::launch::async, [this] {
+                lease(writeConn.get())->prepareRegistered();
+            }));
+            for (auto &conn : readers) {
+                SQLiteHandler *handler = conn.get();
+                tasks.push_back(std::async(std::launch::async, [this, handler] {
+                    lease(handler)->prepareRegistered();
+                }));
+            }
+            std::exception_ptr error;
+            for (auto &task : tasks) {
+                try {
+                    task.get();
+                } catch (...) {
+                    if (!error)
+                        error = std::current_exception();
+                }
+            }
+            if (error)
+                std::rethrow_exception(error);
+        });
+    }
+
+    ConnectionPool::Lease ConnectionPool::lease(SQLiteHandler *connection) {
+        std::unique_lock<std::mutex> guard(lock);
+        if (connection == writeConn.get()) {
+            available.wait(guard, [this] { return !writerBusy; });
+            writerBusy = true;
+            return Lease(this, connection, true);
+        }
+        available.wait(guard, [this, connection] {
+            return std::find(idleReaders.begin(), idleReaders.end(), connection) != idleReaders.end();
+        });
+        idleReaders.erase(std::find(idleReaders.begin(), idleReaders.end(), connection));
+        return Lease(this, connection, false);
+    }
+
+    void ConnectionPool::forEachConnection(const std::function<void(SQLiteHandler &)> &task) {
+        std::unique_lock<std::mutex> guard(lock);
+        available.wait(guard, [this] {
+            return !writerBusy && idleReaders.size() == readers.size();
+        });
+        writerBusy = true;
+        idleReaders.clear();
+        guard.unlock();
+
+        auto restore = [this, &guard] {
+            guard.lock();
+            writerBusy = false;
+            for (auto &conn : readers)
+                idleReaders.push_back(conn.get());
+            available.notify_all();
+        };
+        try {
+            task(*writeConn);
+            for (auto &conn : readers)
+                task(*conn);
+        } catch (...) {
+            restore();
+            throw;
+        }
+        restore();
+    }
+
+    void ConnectionPool::giveBack(SQLiteHandler *connection, const bool isWriter) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (isWriter)
+                writerBusy = false;
+            else
+                idleReaders.push_back(connection);
+        }
+        available.notify_all();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+/**
+ *  ResultSet.cpp
+ *  Provides an owning copy of the full result of a statement, which can
+ *  outlive the statement and be handed between threads
+ *
+ *  @author William Horstkamp
+ */
+
+/**
+ *  SQLiter For C++11 is an SQLite3 wrapper with C++11 features.
+ *  Copyright (C) 2015 William Horstkamp
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a
+ *	copy of this software and associated documentation files (the "Software"),
+ *	to deal in the Software without restriction, including without limitation
+ *	the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *	and/or sell copies of the Software, and to permit persons to whom the
+ *	Software is furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in
+ *	all copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *	OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *	DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ResultSet.h"
+
+namespace SQLiter {
+
+    ResultValue::ResultValue(StatementHandler &stmt, const int column) :
+        type(stmt.getType(column)), integer(0), real(0.0) {
+        switch (type) {
+        case SQLITE_INTEGER:
+            integer = stmt.getInt64(column);
+            break;
+        case SQLITE_FLOAT:
+            real = stmt.getDouble(column);
+            break;
+        case SQLITE_TEXT:
+            bytes = stmt.getString(column);
+            break;
+        case SQLITE_BLOB: {
+            const void *data = stmt.getBlob(column);
+            if (data != nullptr)
+                bytes.assign((const char *)data, stmt.getSize(column));
+            break;
+        }
+        default:
+            type = SQLITE_NULL;
+        }
+    }
+
+    ResultSet::ResultSet(StatementHandler &stmt) {
+        const int columns = stmt.columnCount();
+        for (int i = 0; i < columns; i++)
+            names.push_back(stmt.resultName(i));
+        while (stmt.step()) {
+            for (int i = 0; i < columns; i++)
+                values.push_back(ResultValue(stmt, i));
+        }
+    }
+}
\ No newline at end of file
@@ -28,54 +28,133 @@
  *	DEALINGS IN THE SOFTWARE.
  */
 
+#include <fstream>
+#include <sstream>
+#include <thread>
 #include "SQLiteHandler.h"
+#include "ConnectionPool.h"
+#include "ThreadPool.h"
+
+// Headers older than 3.8.3 lack the flag. The value is fixed by SQLite, and
+// createFunction only passes it to libraries new enough to understand it.
+#ifndef SQLITE_DETERMINISTIC
+#define SQLITE_DETERMINISTIC 0x800
+#endif
 
 namespace SQLiter {
 
-    SQLiteHandler::SQLiteHandler(const std::string location) {
+    /**
+     *  Pooled connections plus a thread pool for reads and a single thread
+     *  for writes, so queued writes never hold up the read threads.
+     */
+    class AsyncWorkers {
+    public:
+        ConnectionPool pool;
+        ThreadPool readers;
+        ThreadPool writer;
+
+        AsyncWorkers(const std::string location, const unsigned threads, const bool useWal) :
+            pool(location, threads, busyMs, useWal), readers(threads), writer(1) {};
+
+        /**
+         *  Milliseconds the worker connections, and the SQLiteHandler's own
+         *  connection once workers are running, wait on a locked database
+         */
+        static const int busyMs = 5000;
+    };
+
+    SQLiteHandler::SQLiteHandler() : asyncThreads(0), asyncWal(false) {}
+
+    SQLiteHandler::SQLiteHandler(const std::string location) : asyncThreads(0), asyncWal(false) {
         forceOpenDatabase(location);
     }
 
     SQLiteHandler::~SQLiteHandler() {
+        stopAsync();
         destroyStatements();
         db.reset();
     }
 
+    SQLiteHandler::SQLiteHandler(SQLiteHandler &&o) noexcept : asyncThreads(0), asyncWal(false) {
+        std::lock_guard<std::mutex> guard(o.asyncLock);
+        takeFrom(o);
+    }
+
+    SQLiteHandler &SQLiteHandler::operator=(SQLiteHandler &&o) noexcept {
+        if (this != &o) {
+            stopAsync();
+            destroyStatements();
+            db.reset();
+            std::lock(asyncLock, o.asyncLock);
+            std::lock_guard<std::mutex> guard(asyncLock, std::adopt_lock);
+            std::lock_guard<std::mutex> otherGuard(o.asyncLock, std::adopt_lock);
+            takeFrom(o);
+        }
+        return *this;
+    }
+
+    void SQLiteHandler::takeFrom(SQLiteHandler &o) {
+        db = std::move(o.db);
+        slots = std::move(o.slots);
+        freeSlots = std::move(o.freeSlots);
+        names = std::move(o.names);
+        cache = std::move(o.cache);
+        path = std::move(o.path);
+        async = std::move(o.async);
+        asyncThreads = o.asyncThreads;
+        asyncWal = o.asyncWal;
+        o.slots.clear();
+        o.freeSlots.clear();
+        o.names.clear();
+        o.cache.clear();
+        o.path.clear();
+    }
+
     void SQLiteHandler::createDatabase(const std::string location) {
        if (!fileExists(location)) {
+            stopAsync();
             sqlite3 *connection = nullptr;
             result(sqlite3_open(location.c_str(), &connection));
-            db.reset(connection);
+            setConnection(connection);
+            path = location;
         } else {
             throw SQLiteException("File Already Exists");
         }
     }
 
     void SQLiteHandler::createDatabase() {
+        stopAsync();
         sqlite3 *connection = nullptr;
         result(sqlite3_open(nullptr, &connection));
-        db.reset(connection);
+        setConnection(connection);
+        path.clear();
     }
 
     void SQLiteHandler::openDatabase(const std::string location) {
         if (fileExists(location)) {
+            stopAsync();
             sqlite3 *connection = nullptr;
             result(sqlite3_open(location.c_str(), &connection));
-            db.reset(connection);
+            setConnection(connection);
+            path = location;
         } else {
             throw SQLiteException("File Does Not Exist");
         }
     }
 
     void SQLiteHandler::closeDatabase() {
+        stopAsync();
         destroyStatements();
         db.reset();
+        path.clear();
     }
 
     void SQLiteHandler::forceOpenDatabase(const std::string location) {
+        stopAsync();
         sqlite3 *connection = nullptr;
         result(sqlite3_open(location.c_str(), &connection));
-        db.reset(connection);
+        setConnection(connection);
+        path = location;
     }
 
     void SQLiteHandler::load(const std::string location) {
@@ -84,7 +163,9 @@ namespace SQLiter {
             sqlite3 *connection;
             result(sqlite3_open(location.c_str(), &file));
             result(sqlite3_open(nullptr, &connection));
-            db.reset(connection);
+            stopAsync();
+            setConnection(connection);
+            path.clear();
             sqlite3_backup *backup = sqlite3_backup_init(db.get(), "main", file, "main");
             if (backup) {
                 result(sqlite3_backup_step(backup, -1));
@@ -112,28 +193,281 @@ namespace SQLiter {
         
     }
 
-    StatementHandler *SQLiteHandler::prepareStatement(const std::string key, const std::string stmtStr) {
-        stmts.insert(std::make_pair(key, std::unique_ptr<StatementHandler>(new StatementHandler(db.get(), stmtStr))));
-        return getStatement(key);
+    StatementId SQLiteHandler::prepareStatement(const StringRef key, const StringRef stmtStr) {
+        const size_t *existing = names.find(key);
+        if (existing != nullptr) {
+            if (!slots[*existing].prepared)
+                slots[*existing].prepare();
+            return idOf(*existing);
+        }
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        StatementHandler stmt(db.get(), stmtStr);
+        const size_t slot = takeSlot(key);
+        slots[slot].stmt = std::move(stmt);
+        slots[slot].prepared = true;
+        slots[slot].prepareSeconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return idOf(slot);
+    }
+
+    StatementId SQLiteHandler::registerStatement(const StringRef key, const StringRef stmtStr) {
+        const size_t *existing = names.find(key);
+        if (existing != nullptr)
+            return idOf(*existing);
+
+        const size_t slot = takeSlot(key);
+        slots[slot].sql = stmtStr.str();
+        return idOf(slot);
+    }
+
+    size_t SQLiteHandler::registerManifest(const StringRef manifest) {
+        static const char marker[] = "-- name:";
+        const size_t markerLen = sizeof(marker) - 1;
+        const char *pos = manifest.data();
+        const char *end = pos + manifest.size();
+        const char *sql = nullptr;
+        std::string key;
+        size_t count = 0;
+
+        auto isSpace = [](const char c) {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        };
+        auto finish = [&](const char *sqlEnd) {
+            while (sql < sqlEnd && isSpace(*sql))
+                sql++;
+            while (sqlEnd > sql && isSpace(sqlEnd[-1]))
+                sqlEnd--;
+            if (sql == sqlEnd)
+                throw SQLiteException(("Manifest Statement Has No SQL: " + key).c_str());
+            registerStatement(key, StringRef(sql, (size_t)(sqlEnd - sql)));
+            count++;
+        };
+
+        while (pos < end) {
+            const char *lineEnd = std::find(pos, end, '\n');
+            const char *text = pos;
+            while (text < lineEnd && (*text == ' ' || *text == '\t'))
+                text++;
+            if ((size_t)(lineEnd - text) >= markerLen && std::equal(marker, marker + markerLen, text)) {
+                if (sql != nullptr)
+                    finish(pos);
+                const char *name = text + markerLen;
+                const char *nameEnd = lineEnd;
+                while (name < nameEnd && isSpace(*name))
+                    name++;
+                while (nameEnd > name && isSpace(nameEnd[-1]))
+                    nameEnd--;
+                if (name == nameEnd)
+                    throw SQLiteException("Manifest Statement Has No Name");
+                key.assign(name, nameEnd);
+                sql = lineEnd;
+            }
+            pos = lineEnd < end ? lineEnd + 1 : end;
+        }
+        if (sql != nullptr)
+            finish(end);
+        return count;
+    }
+
+    std::string SQLiteHandler::readManifest(const std::string location) {
+        std::ifstream file(location, std::ios::in | std::ios::binary);
+        if (!file)
+            throw SQLiteException(("Could Not Open Manifest: " + location).c_str());
+        std::ostringstream text;
+        text << file.rdbuf();
+        return text.str();
+    }
+
+    size_t SQLiteHandler::loadManifest(const std::string location) {
+        return registerManifest(readManifest(location));
+    }
+
+    size_t SQLiteHandler::prepareRegistered() {
+        size_t count = 0;
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (slots[i].used && !slots[i].prepared) {
+                slots[i].prepare();
+                count++;
+            }
+        }
+        return count;
+    }
+
+    std::vector<StatementTiming> SQLiteHandler::statementTimings() const {
+        std::vector<StatementTiming> timings;
+        for (const StatementSlot &slot : slots) {
+            if (!slot.used)
+                continue;
+            StatementTiming timing = { slot.key, slot.prepared,
+                slot.prepared ? slot.prepareSeconds : 0.0 };
+            timings.push_back(timing);
+        }
+        return timings;
+    }
+
+    StatementHandler *SQLiteHandler::getStatement(const StringRef key) {
+        const size_t *slot = names.find(key);
+        if (slot == nullptr)
+            throw std::out_of_range("Statement Does Not Exist");
+        if (!slots[*slot].prepared)
+            slots[*slot].prepare();
+        return &slots[*slot].stmt;
+    }
+
+    StatementId SQLiteHandler::statementId(const StringRef key) {
+        const size_t *slot = names.find(key);
+        if (slot == nullptr)
+            throw std::out_of_range("Statement Does Not Exist");
+        return idOf(*slot);
+    }
+
+    void SQLiteHandler::destroyStatement(const StringRef key) {
+        const size_t *slot = names.find(key);
+        if (slot != nullptr)
+            freeSlot(*slot);
     }
 
-    StatementHandler *SQLiteHandler::getStatement(const std::string key) {
-        return stmts.at(key).get();
+    void SQLiteHandler::destroyStatement(const StatementId id) {
+        if (id.slot < slots.size() && &slots[id.slot] == id.entry
+            && slots[id.slot].generation == id.generation && slots[id.slot].used)
+            freeSlot(id.slot);
     }
 
-    void SQLiteHandler::destroyStatement(const std::string key) {
-        stmts.erase(key);
+    size_t SQLiteHandler::takeSlot(const StringRef key) {
+        size_t slot;
+        if (freeSlots.empty()) {
+            slot = slots.size();
+            slots.push_back(StatementSlot());
+            slots[slot].generation = 0;
+            slots[slot].prepared = false;
+        } else {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        slots[slot].db = db.get();
+        slots[slot].key = key.str();
+        slots[slot].used = true;
+        slots[slot].prepareSeconds = 0.0;
+        names.insert(key, slot);
+        return slot;
+    }
+
+    void StatementSlot::prepare() {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        stmt = StatementHandler(db, sql);
+        prepared = true;
+        prepareSeconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::string().swap(sql);
+    }
+
+    void SQLiteHandler::setConnection(sqlite3 *connection) {
+        db.reset(connection);
+        for (StatementSlot &slot : slots)
+            slot.db = connection;
+    }
+
+    void SQLiteHandler::freeSlot(const size_t slot) {
+        names.erase(slots[slot].key);
+        slots[slot].stmt = StatementHandler();
+        slots[slot].prepared = false;
+        slots[slot].key.clear();
+        std::string().swap(slots[slot].sql);
+        slots[slot].used = false;
+        slots[slot].generation++;
+        freeSlots.push_back(slot);
+    }
+
+    StatementHandler *SQLiteHandler::cached(const StringRef stmtStr) {
+        return cache.get(db.get(), stmtStr);
+    }
+
+    void SQLiteHandler::setCacheCapacity(const size_t maxSize) {
+        cache.setCapacity(maxSize);
+    }
+
+    CacheStats SQLiteHandler::cacheStats() {
+        return cache.getStats();
     }
 
     void SQLiteHandler::destroyStatements() {
-        stmts.clear();
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (slots[i].used)
+                freeSlot(i);
+        }
+        cache.clear();
     }
 
-    int SQLiteHandler::rawExec(const std::string stmtStr) {
-        result(sqlite3_exec(db.get(), stmtStr.c_str(), NULL, NULL, NULL));
+    int SQLiteHandler::rawExec(const StringRef stmtStr) {
+        const char *sql = stmtStr.data();
+        const char *end = sql + stmtStr.size();
+        while (sql < end) {
+            sqlite3_stmt *stmt = nullptr;
+            const char *tail = end;
+            result(sqlite3_prepare_v2(db.get(), sql, (int)(end - sql), &stmt, &tail));
+            if (stmt == nullptr)    // only whitespace or comments were left
+                break;
+            while (sqlite3_step(stmt) == SQLITE_ROW) {}
+            result(sqlite3_finalize(stmt));
+            sql = tail;
+        }
         return changes();
     }
 
+    size_t SQLiteHandler::insertRowsPerStatement(const size_t columns) {
+        if (columns == 0)
+            throw SQLiteException("No Columns To Insert");
+        // multi row VALUES arrived in 3.7.11
+        if (sqlite3_libversion_number() < 3007011)
+            return 1;
+        // statements past SQLite's old default of 999 variables cost more to
+        // prepare and step than they save, so the limit is capped there
+        const size_t variables = std::min((size_t)sqlite3_limit(db.get(), SQLITE_LIMIT_VARIABLE_NUMBER, -1),
+            (size_t)999);
+        size_t rows = variables / columns;
+        // before 3.8.8 each row of VALUES counted as a term of a compound SELECT
+        if (sqlite3_libversion_number() < 3008008)
+            rows = std::min(rows, (size_t)sqlite3_limit(db.get(), SQLITE_LIMIT_COMPOUND_SELECT, -1));
+        return rows > 0 ? rows : 1;
+    }
+
+    std::string SQLiteHandler::insertSQL(const StringRef table, const std::vector<std::string> &columns,
+        const size_t rows) {
+        std::string row = "(?";
+        for (size_t i = 1; i < columns.size(); i++)
+            row += ",?";
+        row += ")";
+
+        std::string sql = "INSERT INTO ";
+        sql.reserve(sql.size() + table.size() + columns.size() * 16 + rows * (row.size() + 1) + 16);
+        sql.append(table.data(), table.size());
+        sql += " (";
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (i > 0)
+                sql += ",";
+            sql += columns[i];
+        }
+        sql += ") VALUES ";
+        for (size_t i = 0; i < rows; i++) {
+            if (i > 0)
+                sql += ",";
+            sql += row;
+        }
+        return sql;
+    }
+
+    void SQLiteHandler::runInsert(StatementHandler *stmt) {
+        stmt->step();
+        const int resCode = errorCode();
+        stmt->reset();
+        result(resCode);
+    }
+
+    std::unique_ptr<Script> SQLiteHandler::script(const StringRef stmtStr, const bool transaction) {
+        return std::unique_ptr<Script>(new Script(db.get(), stmtStr, transaction));
+    }
+
     void SQLiteHandler::result(const int resCode) {
         if (resCode != SQLITE_OK && resCode != SQLITE_DONE)
             throw SQLiteException(sqlite3_errmsg(db.get()));
@@ -153,6 +487,45 @@ namespace SQLiter {
             SQLITE_UTF8, pApp, NULL, xStep, xFinal, xDestroy));
     }
 
+    void SQLiteHandler::createFunction(const std::string name, const int nArg,
+        const bool deterministic, void *pApp,
+        void(*xFunc)(sqlite3_context*, int, sqlite3_value**),
+        void(*xStep)(sqlite3_context*, int, sqlite3_value**),
+        void(*xFinal)(sqlite3_context*), void(*xDestroy)(void*)) {
+        int textRep = SQLITE_UTF8;
+        if (deterministic && sqlite3_libversion_number() >= 3008003)
+            textRep |= SQLITE_DETERMINISTIC;
+        result(sqlite3_create_function_v2(db.get(), name.c_str(), nArg, textRep, pApp,
+            xFunc, xStep, xFinal, xDestroy));
+    }
+
+    void SQLiteHandler::createWindowFunction(const std::string name, const int nArg,
+        const bool deterministic, void(*xStep)(sqlite3_context*, int, sqlite3_value**),
+        void(*xFinal)(sqlite3_context*), void(*xValue)(sqlite3_context*),
+        void(*xInverse)(sqlite3_context*, int, sqlite3_value**)) {
+#if SQLITE_VERSION_NUMBER >= 3025000
+        if (sqlite3_libversion_number() < 3025000) {
+            throw SQLiteException(("Window Functions Need SQLite 3.25.0, Running " +
+                std::string(sqlite3_libversion())).c_str());
+        }
+        int textRep = SQLITE_UTF8;
+        if (deterministic)
+            textRep |= SQLITE_DETERMINISTIC;
+        result(sqlite3_create_window_function(db.get(), name.c_str(), nArg, textRep, nullptr,
+            xStep, xFinal, xValue, xInverse, nullptr));
+#else
+        (void)name;
+        (void)nArg;
+        (void)deterministic;
+        (void)xStep;
+        (void)xFinal;
+        (void)xValue;
+        (void)xInverse;
+        throw SQLiteException("Window Functions Need SQLite 3.25.0, Built Against "
+            SQLITE_VERSION);
+#endif
+    }
+
     void SQLiteHandler::deleteFunction(const std::string name) {
         result(sqlite3_create_function_v2(db.get(), name.c_str(), NULL,
             SQLITE_UTF8, NULL, NULL, NULL, NULL, NULL));
@@ -162,6 +535,10 @@ namespace SQLiter {
         return sqlite3_changes(db.get());
     }
 
+    sqlite3_int64 SQLiteHandler::lastInsertRowid() {
+        return sqlite3_last_insert_rowid(db.get());
+    }
+
     int SQLiteHandler::totalChanges() {
         return sqlite3_total_changes(db.get());
     }
@@ -173,4 +550,60 @@ namespace SQLiter {
     const std::string SQLiteHandler::errorMsg() {
         return sqlite3_errmsg(db.get());
     }
+
+    void SQLiteHandler::busyTimeout(const int ms) {
+        result(sqlite3_busy_timeout(db.get(), ms));
+    }
+
+    std::unique_ptr<BlobStream> SQLiteHandler::openBlob(const std::string table, const std::string column,
+        const sqlite3_int64 row, const bool write, const std::string database, const size_t chunkSize) {
+        return std::unique_ptr<BlobStream>(new BlobStream(db.get(), database, table, column, row,
+            write, chunkSize));
+    }
+
+    void SQLiteHandler::setAsyncThreads(const unsigned threads) {
+        std::lock_guard<std::mutex> guard(asyncLock);
+        asyncThreads = threads;
+    }
+
+    void SQLiteHandler::setAsyncWal(const bool wal) {
+        std::lock_guard<std::mutex> guard(asyncLock);
+        asyncWal = wal;
+    }
+
+    void SQLiteHandler::submitAsync(const bool write, std::function<void(SQLiteHandler &)> task) {
+        std::lock_guard<std::mutex> guard(asyncLock);
+        if (!async) {
+            if (path.empty())
+                throw SQLiteException("Asynchronous Execution Requires A Database File");
+            unsigned threads = asyncThreads;
+            if (threads == 0)
+                threads = std::thread::hardware_concurrency();
+            async.reset(new AsyncWorkers(path, threads > 0 ? threads : 1, asyncWal));
+            // the workers add a second writer to the file, so our own writes
+            // must wait for theirs rather than fail with SQLITE_BUSY
+            sqlite3_busy_timeout(db.get(), AsyncWorkers::busyMs);
+        }
+        ConnectionPool *pool = &async->pool;
+        if (write) {
+            async->writer.post([pool, task] {
+                ConnectionPool::Lease conn = pool->writer();
+                task(*conn);
+            });
+        } else {
+            async->readers.post([pool, task] {
+                ConnectionPool::Lease conn = pool->reader();
+                task(*conn);
+            });
+        }
+    }
+
+    void SQLiteHandler::stopAsync() {
+        std::unique_ptr<AsyncWorkers> workers;
+        {
+            std::lock_guard<std::mutex> guard(asyncLock);
+            workers = std::move(async);
+        }
+        workers.reset();
+    }
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+/**
+ *  Script.cpp
+ *  Provides a sequence of SQL statements that is parsed once and can be run
+ *  any number of times
+ *
+ *  @author William Horstkamp
+ */
+
+/**
+ *  SQLiter For C++11 is an SQLite3 wrapper with C++11 features.
+ *  Copyright (C) 2015 William Horstkamp
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a
+ *	copy of this software and associated documentation files (the "Software"),
+ *	to deal in the Software without restriction, including without limitation
+ *	the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *	and/or sell copies of the Software, and to permit persons to whom the
+ *	Software is furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in
+ *	all copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *	OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *	DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "Script.h"
+#include "SQLiteException.h"
+
+namespace SQLiter {
+
+    Script::Script(sqlite3 *connection, const StringRef stmtStr, const bool useTransaction) :
+        db(connection), sql(stmtStr.str()), transaction(useTransaction), parsed(0) {}
+
+    bool Script::prepareNext() {
+        if (parsed >= sql.size())
+            return false;
+        sqlite3_stmt *stmt = nullptr;
+        const char *start = sql.data() + parsed;
+        const char *tail = sql.data() + sql.size();
+        if (sqlite3_prepare_v2(db, start, (int)(sql.size() - parsed), &stmt, &tail) != SQLITE_OK)
+            throw SQLiteException(sqlite3_errmsg(db));
+        if (stmt == nullptr) {  // only whitespace or comments were left
+            parsed = sql.size();
+            return false;
+        }
+        parsed = tail - sql.data();
+        statements.push_back(Statement(stmt));
+        return true;
+    }
+
+    Script::Statement Script::prepare(const char *stmtStr) {
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db, stmtStr, -1, &stmt, nullptr) != SQLITE_OK)
+            throw SQLiteException(sqlite3_errmsg(db));
+        return Statement(stmt);
+    }
+
+    void Script::execute(sqlite3_stmt *stmt) {
+        int resCode;
+        while ((resCode = sqlite3_step(stmt)) == SQLITE_ROW) {}
+        if (resCode != SQLITE_DONE) {
+            const std::string message = sqlite3_errmsg(db);
+            sqlite3_reset(stmt);
+            throw SQLiteException(message.c_str());
+        }
+        sqlite3_reset(stmt);
+    }
+
+    int Script::run() {
+        const int before = sqlite3_total_changes(db);
+        if (transaction) {
+            if (!begin) {
+                begin = prepare("BEGIN IMMEDIATE");
+                commit = prepare("COMMIT");
+                rollback = prepare("ROLLBACK");
+            }
+            execute(begin.get());
+        }
+        try {
+            for (size_t i = 0; i < statements.size() || prepareNext(); i++)
+                execute(statements[i].get());
+            if (transaction)
+                execute(commit.get());
+        } catch (...) {
+            if (transaction) {
+                sqlite3_step(rollback.get());
+                sqlite3_reset(rollback.get());
+            }
+            throw;
+        }
+        return sqlite3_total_changes(db) - before;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+/**
+ *  StatementCache.cpp
+ *  Provides a bounded least recently used cache of prepared statements keyed
+ *  by their SQL text
+ *
+ *  @author William Horstkamp
+ */
+
+/**
+ *  SQLiter For C++11 is an SQLite3 wrapper with C++11 features.
+ *  Copyright (C) 2015 William Horstkamp
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a
+ *	copy of this software and associated documentation files (the "Software"),
+ *	to deal in the Software without restriction, including without limitation
+ *	the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *	and/or sell copies of the Software, and to permit persons to whom the
+ *	Software is furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in
+ *	all copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *	OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *	DEALINGS IN THE SOFTWARE.
+ */
+
+#include <iterator>
+#include "SQLiteException.h"
+#include "StatementCache.h"
+
+namespace SQLiter {
+
+    StatementCache::StatementCache(const size_t maxSize) :
+        capacity(maxSize > 0 ? maxSize : 1) {
+        stats.hits = 0;
+        stats.misses = 0;
+        stats.evictions = 0;
+    }
+
+    StatementHandler *StatementCache::get(sqlite3 *db, const StringRef stmtStr) {
+        const unsigned long long hash = stmtStr.hash();
+        auto range = index.equal_range(hash);
+        for (auto found = range.first; found != range.second; ++found) {
+            if (StringRef(found->second->first) == stmtStr) {
+                stats.hits++;
+                entries.splice(entries.begin(), entries, found->second);
+                StatementHandler *stmt = found->second->second.get();
+                stmt->reset();
+                return stmt;
+            }
+        }
+
+        stats.misses++;
+        std::unique_ptr<StatementHandler> stmt(new StatementHandler(db, stmtStr));
+        if (sqlite3_errcode(db) != SQLITE_OK)
+            throw SQLiteException(sqlite3_errmsg(db));
+        entries.push_front(std::make_pair(stmtStr.str(), std::move(stmt)));
+        index.insert(std::make_pair(hash, entries.begin()));
+        trim();
+        return entries.front().second.get();
+    }
+
+    void StatementCache::setCapacity(const size_t maxSize) {
+        capacity = maxSize > 0 ? maxSize : 1;
+        trim();
+    }
+
+    void StatementCache::clear() {
+        index.clear();
+        entries.clear();
+    }
+
+    void StatementCache::trim() {
+        while (entries.size() > capacity) {
+            auto last = std::prev(entries.end());
+            auto range = index.equal_range(StringRef(last->first).hash());
+            for (auto found = range.first; found != range.second; ++found) {
+                if (found->second == last) {
+                    index.erase(found);
+                    break;
+                }
+            }
+            entries.pop_back();
+            stats.evictions++;
+        }
+    }
+}
\ No newline at end of file
@@ -30,16 +30,44 @@
  *	DEALINGS IN THE SOFTWARE.
  */
 
-#include <cstring>
 #include "SQLiteException.h"
 #include "StatementHandler.h"
 
 namespace SQLiter {
 
-    StatementHandler::StatementHandler(sqlite3 *db, const std::string stmtStr) {
-        sqlite3_stmt *prepStmt;
-        sqlite3_prepare_v2(db, stmtStr.c_str(), strlen(stmtStr.c_str()), &prepStmt, nullptr);
+    const int StatementHandler::ambiguousAlias;
+
+    StatementHandler::StatementHandler() :
+        executor(nullptr), rowGeneration(0), lastResult(SQLITE_OK) {}
+
+    StatementHandler::StatementHandler(sqlite3 *db, const StringRef stmtStr) :
+        executor(nullptr), rowGeneration(0), lastResult(SQLITE_OK) {
+        sqlite3_stmt *prepStmt = nullptr;
+        sqlite3_prepare_v2(db, stmtStr.data(), (int)stmtStr.size(), &prepStmt, nullptr);
         stmt = std::unique_ptr<sqlite3_stmt, Closesqlite3_stmt>(prepStmt);
+        if (prepStmt != nullptr)
+            resolveNames();
+    }
+
+    void StatementHandler::resolveNames() {
+        const int params = sqlite3_bind_parameter_count(stmt.get());
+        for (int i = 1; i <= params; i++) {
+            const char *name = sqlite3_bind_parameter_name(stmt.get(), i);
+            // nameless ? and numbered ?NNN variables have nothing to resolve
+            if (name == nullptr || name[0] == '?')
+                continue;
+            inputAlias.insert(name, i);
+            // :a, @a and $a are separate variables that share the bare name a
+            if (!inputAlias.insert(stripPrefix(name), i))
+                inputAlias.assign(stripPrefix(name), ambiguousAlias);
+        }
+        const int columns = sqlite3_column_count(stmt.get());
+        for (int i = 0; i < columns; i++) {
+            const char *name = sqlite3_column_name(stmt.get(), i);
+            // SELECT a.id, b.id names two columns id
+            if (name != nullptr && !outputAlias.insert(name, i))
+                outputAlias.assign(name, ambiguousAlias);
+        }
     }
 
     StatementHandler::~StatementHandler() {
@@ -48,8 +76,79 @@ namespace SQLiter {
         stmt.reset();
     }
 
-    void StatementHandler::bind(const int var, const std::string input) {
-        sqlite3_bind_text(stmt.get(), var, input.c_str(), strlen(input.c_str()), SQLITE_TRANSIENT);
+    StatementHandler::StatementHandler(StatementHandler &&o) noexcept :
+        stmt(std::move(o.stmt)), inputAlias(std::move(o.inputAlias)),
+        outputAlias(std::move(o.outputAlias)), executor(o.executor),
+        ownedText(std::move(o.ownedText)), ownedBlobs(std::move(o.ownedBlobs)),
+        rowGeneration(o.rowGeneration), lastResult(o.lastResult) {
+        o.inputAlias.clear();
+        o.outputAlias.clear();
+        o.ownedText.clear();
+        o.ownedBlobs.clear();
+        o.executor = nullptr;
+        o.rowGeneration++;
+        o.lastResult = SQLITE_OK;
+    }
+
+    StatementHandler &StatementHandler::operator=(StatementHandler &&o) noexcept {
+        if (this != &o) {
+            // the statement goes first, it may still point into our buffers
+            stmt = std::move(o.stmt);
+            inputAlias = std::move(o.inputAlias);
+            outputAlias = std::move(o.outputAlias);
+            executor = o.executor;
+            ownedText = std::move(o.ownedText);
+            ownedBlobs = std::move(o.ownedBlobs);
+            rowGeneration++;
+            lastResult = o.lastResult;
+            o.inputAlias.clear();
+            o.outputAlias.clear();
+            o.ownedText.clear();
+            o.ownedBlobs.clear();
+            o.executor = nullptr;
+            o.rowGeneration++;
+            o.lastResult = SQLITE_OK;
+        }
+        return *this;
+    }
+
+    void StatementHandler::bind(const int var, const StringRef input) {
+        bindText(stmt.get(), var, input.data(), input.size(), SQLITE_TRANSIENT);
+    }
+
+    void StatementHandler::bind(const int var, std::string &&input) {
+        if (ownedText.empty())
+            ownedText.resize(sqlite3_bind_parameter_count(stmt.get()) + 1);
+        if (var < 1 || var >= (int)ownedText.size()) {
+            bind(var, StringRef(input));    // let SQLite report the bad index
+            return;
+        }
+        std::string previous(std::move(ownedText[var]));
+        ownedText[var] = std::move(input);
+        bindText(stmt.get(), var, ownedText[var].data(), ownedText[var].size(), SQLITE_STATIC);
+    }
+
+    void StatementHandler::bind(const int var, std::vector<unsigned char> &&input) {
+        if (ownedBlobs.empty())
+            ownedBlobs.resize(sqlite3_bind_parameter_count(stmt.get()) + 1);
+        if (var < 1 || var >= (int)ownedBlobs.size()) {
+            bind(var, input.data(), input.size());
+            return;
+        }
+        std::vector<unsigned char> previous(std::move(ownedBlobs[var]));
+        ownedBlobs[var] = std::move(input);
+        if (ownedBlobs[var].empty())
+            sqlite3_bind_zeroblob(stmt.get(), var, 0);
+        else
+            bindBlob(stmt.get(), var, ownedBlobs[var].data(), ownedBlobs[var].size(), SQLITE_STATIC);
+    }
+
+    void StatementHandler::bindStatic(const int var, const StringRef input) {
+        bindText(stmt.get(), var, input.data(), input.size(), SQLITE_STATIC);
+    }
+
+    void StatementHandler::bindStatic(const int var, const void *input, const size_t size) {
+        bindBlob(stmt.get(), var, input, size, SQLITE_STATIC);
     }
 
     void StatementHandler::bind(const int var, const int input) {
@@ -60,14 +159,24 @@ namespace SQLiter {
         sqlite3_bind_double(stmt.get(), var, input);
     }
 
-    void StatementHandler::bind(const int var, const void *input, const int size) {
-        sqlite3_bind_blob(stmt.get(), var, input, size, SQLITE_TRANSIENT);
+    void StatementHandler::bind(const int var, const void *input, const size_t size) {
+        bindBlob(stmt.get(), var, input, size, SQLITE_TRANSIENT);
     }
 
     void StatementHandler::bindNull(const int var) {
         sqlite3_bind_null(stmt.get(), var);
     }
 
+    void StatementHandler::bindZeroBlob(const int var, const size_t size) {
+#if SQLITE_VERSION_NUMBER >= 3008011
+        sqlite3_bind_zeroblob64(stmt.get(), var, (sqlite3_uint64)size);
+#else
+        if (size > (size_t)INT_MAX)
+            throw SQLiteException("Blob Too Large To Bind");
+        sqlite3_bind_zeroblob(stmt.get(), var, (int)size);
+#endif
+    }
+
     const int StatementHandler::getType(const int column) {
         int typeNum = sqlite3_column_type(stmt.get(), column);
         return (typeNum >= SQLITE_INTEGER && typeNum <= SQLITE_NULL ? typeNum : 0);
@@ -78,33 +187,31 @@ namespace SQLiter {
     }
 
     const std::string StatementHandler::getString(const int column) {
-        if (getType(column) == SQLITE_TEXT) {
-            return std::string((const char*)sqlite3_column_text(stmt.get(), column));
-        } throw SQLiteException("Column doesn't contain a string");
+        return access<Checked>().getString(column);
     }
 
     const int StatementHandler::getInt(const int column) {
-        if (getType(column) == SQLITE_INTEGER) {
-            return sqlite3_column_int(stmt.get(), column);
-        } throw SQLiteException("Column doesn't contain a int");
+        return access<Checked>().getInt(column);
     }
 
     const sqlite3_int64 StatementHandler::getInt64(const int column) {
-        if (getType(column) == SQLITE_INTEGER) {
-            return sqlite3_column_int64(stmt.get(), column);
-        } throw SQLiteException("Column doesn't contain a int");
+        return access<Checked>().getInt64(column);
     }
 
     const double StatementHandler::getDouble(const int column) {
-        if (getType(column) == SQLITE_FLOAT) {
-            return sqlite3_column_double(stmt.get(), column);
-        } throw SQLiteException("Column doesn't contain a float");
+        return access<Checked>().getDouble(column);
     }
 
     const void *StatementHandler::getBlob(const int column) {
-        if (getType(column) == SQLITE_BLOB) {
-            return sqlite3_column_blob(stmt.get(), column);
-        } throw SQLiteException("Column doesn't contain a blob");
+        return access<Checked>().getBlob(column);
+    }
+
+    TextView StatementHandler::getStringView(const int column) {
+        return access<Checked>().getStringView(column);
+    }
+
+    BlobView StatementHandler::getBytes(const int column) {
+        return access<Checked>().getBytes(column);
     }
 
     const ValueHandler StatementHandler::getColumn(const int column) {
@@ -112,21 +219,76 @@ namespace SQLiter {
     }
 
     const bool StatementHandler::step() {
-        return (sqlite3_step(stmt.get()) == SQLITE_ROW);
+        rowGeneration++;
+        lastResult = sqlite3_step(stmt.get());
+        return (lastResult == SQLITE_ROW);
     }
 
     void StatementHandler::reset() {
+        rowGeneration++;
+        lastResult = SQLITE_OK;
         sqlite3_reset(stmt.get());
     }
 
+    void StatementHandler::setExecutor(Executor *exec) {
+        executor = exec;
+    }
+
+    StepAwaitable StatementHandler::stepAsync() {
+        if (executor == nullptr)
+            throw SQLiteException("No Executor Set");
+        return StepAwaitable(this, executor, false);
+    }
+
+    StepAwaitable StatementHandler::stepAsync(Executor &exec) {
+        return StepAwaitable(this, &exec, false);
+    }
+
+    AsyncRows StatementHandler::rowsAsync() {
+        if (executor == nullptr)
+            throw SQLiteException("No Executor Set");
+        return AsyncRows(this, executor);
+    }
+
+    AsyncRows StatementHandler::rowsAsync(Executor &exec) {
+        return AsyncRows(this, &exec);
+    }
+
+    RowRange StatementHandler::rows() {
+        return RowRange(this);
+    }
+
+    ColumnAccess<Unchecked> StatementHandler::unchecked() {
+        return ColumnAccess<Unchecked>(this, &rowGeneration);
+    }
+
+    size_t StatementHandler::fetchColumnar(ColumnBatch &batch, const size_t maxRows) {
+        batch.start(stmt.get(), maxRows);
+        if (lastResult != SQLITE_OK && lastResult != SQLITE_ROW)
+            return 0;
+        while (batch.rowCount() < maxRows && step())
+            batch.append(stmt.get());
+        if (lastResult != SQLITE_ROW && lastResult != SQLITE_DONE)
+            throw SQLiteException(sqlite3_errmsg(sqlite3_db_handle(stmt.get())));
+        return batch.rowCount();
+    }
+
     void StatementHandler::clear() {
         sqlite3_clear_bindings(stmt.get());
+        for (auto &text : ownedText)
+            std::string().swap(text);
+        for (auto &blob : ownedBlobs)
+            std::vector<unsigned char>().swap(blob);
     }
 
     const int StatementHandler::columnCount() {
         return sqlite3_column_count(stmt.get());
     }
 
+    int StatementHandler::parameterCount() {
+        return sqlite3_bind_parameter_count(stmt.get());
+    }
+
     const std::string StatementHandler::databaseName(const int col) {
         return sqlite3_column_database_name(stmt.get(), col);
     }
@@ -139,11 +301,18 @@ namespace SQLiter {
         return sqlite3_column_origin_name(stmt.get(), col);
     }
 
-    void StatementHandler::setInputAlias(const std::string alias, const int colNum) {
-        inputAlias.insert(std::pair<std::string, int>(alias, colNum));
+    const std::string StatementHandler::resultName(const int col) {
+        const char *name = sqlite3_column_name(stmt.get(), col);
+        return name != nullptr ? name : "";
+    }
+
+    void StatementHandler::setInputAlias(const StringRef alias, const int colNum) {
+        inputAlias.assign(alias, colNum);
+        if (stripPrefix(alias).size() != alias.size())
+            inputAlias.assign(stripPrefix(alias), colNum);
     }
 
-    void StatementHandler::setOutputAlias(const std::string alias, const int colNum) {
-        outputAlias.insert(std::pair<std::string, int>(alias, colNum));
+    void StatementHandler::setOutputAlias(const StringRef alias, const int colNum) {
+        outputAlias.assign(alias, colNum);
     }
 }
\ No newline at end of file
@@ -0,0 +1,214 @@
+/**
+ *  WriteExecutor.cpp
+ *  Provides a dedicated writer thread that batches write jobs submitted from
+ *  any thread into shared transactions
+ *
+ *  @author William Horstkamp
+ */
+
+/**
+ *  SQLiter For C++11 is an SQLite3 wrapper with C++11 features.
+ *  Copyright (C) 2015 William Horstkamp
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a
+ *	copy of this software and associated documentation files (the "Software"),
+ *	to deal in the Software without restriction, including without limitation
+ *	the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *	and/or sell copies of the Software, and to permit persons to whom the
+ *	Software is furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in
+ *	all copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *	OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *	FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *	DEALINGS IN THE SOFTWARE.
+ */
+
+#include "WriteExecutor.h"
+
+namespace SQLiter {
+
+    WriteExecutor::WriteExecutor(SQLiteHandler &handler, const size_t maxBatch,
+        const std::chrono::milliseconds maxLatency) :
+        db(handler), batchSize(maxBatch > 0 ? maxBatch : 1), latency(maxLatency),
+        head(&stub), tail(&stub), stopping(false), sleeping(false), producers(0) {
+        worker = std::thread(&WriteExecutor::loop, this);
+    }
+
+    WriteExecutor::~WriteExecutor() {
+        stopping.store(true);
+        {
+            std::lock_guard<std::mutex> guard(wakeLock);
+            wake.notify_one();
+        }
+        worker.join();
+        // an enqueue that saw stopping false before it was set may still be
+        // pushing; producers is checked after stopping is set, so every such
+        // push is visible once the count drops to zero
+        while (producers.load() != 0)
+            std::this_thread::yield();
+        failRemaining();
+    }
+
+    void WriteExecutor::enqueue(Job *job) {
+        producers.fetch_add(1);
+        if (stopping.load()) {
+            producers.fetch_sub(1);
+            delete job;
+            throw SQLiteException("Executor Is Stopping");
+        }
+        push(job);
+        // pairs with the fence in waitForJob: either the writer thread sees
+        // the push when it checks the queue, or we see it asleep
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> guard(wakeLock);
+            wake.notify_one();
+        }
+        producers.fetch_sub(1);
+    }
+
+    void WriteExecutor::push(Node *node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node *prev = head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    WriteExecutor::Job *WriteExecutor::pop() {
+        Node *first = tail;
+        Node *next = first->next.load(std::memory_order_acquire);
+        if (first == &stub) {
+            if (next == nullptr)
+                return nullptr;
+            tail = next;
+            first = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            tail = next;
+            return static_cast<Job *>(first);
+        }
+        if (first != head.load(std::memory_order_acquire))
+            return nullptr;     // a producer is part way through a push
+        push(&stub);
+        next = first->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            tail = next;
+            return static_cast<Job *>(first);
+        }
+        return nullptr;
+    }
+
+    WriteExecutor::Job *WriteExecutor::waitForJob(const std::chrono::steady_clock::time_point deadline) {
+        Job *job = pop();
+        while (job == nullptr && !stopping.load()
+            && std::chrono::steady_clock::now() < deadline) {
+            std::unique_lock<std::mutex> guard(wakeLock);
+            sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            job = pop();
+            if (job == nullptr && !stopping.load()) {
+                if (deadline == std::chrono::steady_clock::time_point::max())
+                    wake.wait(guard);
+                else
+                    wake.wait_until(guard, deadline);
+            }
+            sleeping.store(false);
+            if (job == nullptr)
+                job = pop();
+        }
+        return job;
+    }
+
+    void WriteExecutor::failRemaining() {
+        const std::exception_ptr stopped =
+            std::make_exception_ptr(SQLiteException("Executor Is Stopping"));
+        while (true) {
+            Job *job = pop();
+            if (job == nullptr) {
+                if (head.load() == tail)
+                    break;
+                // a push finished its exchange but not its link yet
+                std::this_thread::yield();
+                continue;
+            }
+            job->error = stopped;
+            job->finish();
+            delete job;
+        }
+    }
+
+    void WriteExecutor::runJob(Job *job) {
+        try {
+            db.rawExec("SAVEPOINT sqliter_job");
+        } catch (...) {
+            job->error = std::current_exception();
+            return;
+        }
+        try {
+            job->run(db);
+            db.rawExec("RELEASE sqliter_job");
+        } catch (...) {
+            job->error = std::current_exception();
+            try {
+                db.rawExec("ROLLBACK TO sqliter_job");
+                db.rawExec("RELEASE sqliter_job");
+            } catch (...) {}
+        }
+    }
+
+    void WriteExecutor::loop() {
+        std::vector<Job *> batch;
+        batch.reserve(batchSize);
+        while (true) {
+            Job *job = waitForJob(std::chrono::steady_clock::time_point::max());
+            if (job == nullptr) {
+                if (stopping.load() && (job = pop()) == nullptr)
+                    break;
+                if (job == nullptr)
+                    continue;
+            }
+
+            const auto deadline = std::chrono::steady_clock::now() + latency;
+            std::exception_ptr batchError;
+            try {
+                db.rawExec("BEGIN IMMEDIATE");
+            } catch (...) {
+                batchError = std::current_exception();
+            }
+            while (job != nullptr) {
+                batch.push_back(job);
+                if (batchError)
+                    job->error = batchError;
+                else
+                    runJob(job);
+                if (batch.size() >= batchSize)
+                    break;
+                job = waitForJob(deadline);
+            }
+            if (!batchError) {
+                try {
+                    db.rawExec("COMMIT");
+                } catch (...) {
+                    batchError = std::current_exception();
+                    try {
+                        db.rawExec("ROLLBACK");
+                    } catch (...) {}
+                }
+            }
+
+            for (Job *done : batch) {
+                if (batchError)
+                    done->error = batchError;
+                done->finish();
+                delete done;
+            }
+            batch.clear();
+        }
+    }
+}
\ No newline at end of file
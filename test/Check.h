@@ -0,0 +1,47 @@
+/**
+ *  Check.h
+ *  Provides the checks used by the standalone test programs in this
+ *  directory. Each test is its own program, built against the sources in
+ *  src and the system SQLite3, and exits with a non-zero status on the
+ *  first failed check.
+ *
+ *  Useage:     g++ -std=c++11 -pthread -Iinclude src/*.cpp test/MoveTest.cpp -lsqlite3
+ *
+ *  @author William Horstkamp
+ */
+
+#ifndef SQLITER_TEST_CHECK_H
+#define SQLITER_TEST_CHECK_H
+
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ *  Fails the test unless a condition holds.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::exit(1); \
+        } \
+    } while (0)
+
+/**
+ *  Fails the test unless an expression throws an exception of the given type.
+ */
+#define CHECK_THROWS(expr, type) \
+    do { \
+        bool thrown = false; \
+        try { \
+            expr; \
+        } catch (const type &) { \
+            thrown = true; \
+        } \
+        if (!thrown) { \
+            std::fprintf(stderr, "%s:%d: CHECK_THROWS failed: %s\n", __FILE__, __LINE__, #expr); \
+            std::exit(1); \
+        } \
+    } while (0)
+
+#endif
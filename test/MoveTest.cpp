@@ -0,0 +1,79 @@
+/**
+ *  MoveTest.cpp
+ *  Checks that moving an SQLiteHandler carries its database, prepared and
+ *  lazily registered statements and cached statements over to the new
+ *  handler, and leaves the old one without a database
+ *
+ *  @author William Horstkamp
+ */
+
+#include <utility>
+#include "SQLiteHandler.h"
+#include "Check.h"
+
+using namespace SQLiter;
+
+/**
+ *  Handles taken before a move, checked against the handler moved to.
+ */
+struct Handles {
+    StatementId prepared;
+    StatementId lazy;
+    StatementHandler *cached;
+};
+
+static Handles setUp(SQLiteHandler &db) {
+    db.createDatabase();
+    db.rawExec("CREATE TABLE t(a INTEGER); INSERT INTO t VALUES(1); INSERT INTO t VALUES(2);");
+    Handles handles;
+    handles.prepared = db.prepareStatement("sum", "SELECT sum(a) FROM t");
+    handles.lazy = db.registerStatement("ins", "INSERT INTO t VALUES(?)");
+    handles.cached = db.cached("SELECT max(a) FROM t");
+    return handles;
+}
+
+static void checkMoved(SQLiteHandler &db, SQLiteHandler &old, const Handles &handles) {
+    handles.lazy->bind(1, 4);
+    CHECK(!handles.lazy->step());
+    handles.lazy->reset();
+
+    CHECK(handles.prepared->step());
+    CHECK(handles.prepared->getInt(0) == 7);
+    handles.prepared->reset();
+
+    CHECK(db.getStatement("sum") == (StatementHandler *)handles.prepared);
+    CHECK(db.getStatement("ins") == (StatementHandler *)handles.lazy);
+    CHECK(db.getStatement(handles.lazy) == (StatementHandler *)handles.lazy);
+    CHECK(db.cached("SELECT max(a) FROM t") == handles.cached);
+    CHECK(handles.cached->step());
+    CHECK(handles.cached->getInt(0) == 4);
+    handles.cached->reset();
+
+    CHECK_THROWS(old.getStatement("sum"), std::out_of_range);
+    CHECK_THROWS(old.getStatement(handles.prepared), std::out_of_range);
+    CHECK_THROWS(old.rawExec("SELECT 1"), SQLiteException);
+}
+
+static void moveConstruct() {
+    SQLiteHandler old;
+    const Handles handles = setUp(old);
+    SQLiteHandler db(std::move(old));
+    checkMoved(db, old, handles);
+}
+
+static void moveAssign() {
+    SQLiteHandler old;
+    const Handles handles = setUp(old);
+    SQLiteHandler db;
+    db.createDatabase();
+    db.registerStatement("gone", "SELECT 1");
+    db = std::move(old);
+    checkMoved(db, old, handles);
+    CHECK_THROWS(db.getStatement("gone"), std::out_of_range);
+}
+
+int main() {
+    moveConstruct();
+    moveAssign();
+    return 0;
+}
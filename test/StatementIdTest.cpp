@@ -0,0 +1,80 @@
+/**
+ *  StatementIdTest.cpp
+ *  Checks that StatementIds, including ones for lazily registered
+ *  statements, keep working after their SQLiteHandler has been moved
+ *
+ *  @author William Horstkamp
+ */
+
+#include <utility>
+#include <vector>
+#include "SQLiteHandler.h"
+#include "Check.h"
+
+using namespace SQLiter;
+
+/**
+ *  A lazy id used after its handler was moved into a vector and the
+ *  original went out of scope, then after the vector reallocated.
+ */
+static void lazyIdAfterMove() {
+    std::vector<SQLiteHandler> handlers;
+    StatementId ins;
+    StatementId count;
+    {
+        SQLiteHandler db;
+        db.createDatabase();
+        db.rawExec("CREATE TABLE t(a INTEGER)");
+        ins = db.registerStatement("ins", "INSERT INTO t VALUES(?)");
+        count = db.registerStatement("count", "SELECT count(*) FROM t");
+        handlers.push_back(std::move(db));
+    }
+    ins->bind(1, 5);
+    CHECK(!ins->step());
+    ins->reset();
+
+    for (int i = 0; i < 16; i++)
+        handlers.emplace_back();
+
+    CHECK(count->step());
+    CHECK(count->getInt(0) == 1);
+    count->reset();
+    CHECK(handlers[0].getStatement(count) == (StatementHandler *)count);
+}
+
+/**
+ *  Ids of destroyed statements throw instead of reaching the statement
+ *  that reused their slot.
+ */
+static void destroyedId() {
+    SQLiteHandler db;
+    db.createDatabase();
+    StatementId first = db.registerStatement("first", "SELECT 1");
+    db.destroyStatement("first");
+    StatementId second = db.prepareStatement("second", "SELECT 2");
+    CHECK_THROWS(first->step(), std::out_of_range);
+    CHECK_THROWS(db.getStatement(first), std::out_of_range);
+    CHECK(second->step());
+    CHECK(second->getInt(0) == 2);
+}
+
+/**
+ *  An id from one handler is not accepted by another.
+ */
+static void foreignId() {
+    SQLiteHandler a;
+    SQLiteHandler b;
+    a.createDatabase();
+    b.createDatabase();
+    StatementId id = a.registerStatement("q", "SELECT 1");
+    b.registerStatement("q", "SELECT 1");
+    CHECK_THROWS(b.getStatement(id), std::out_of_range);
+    CHECK(StatementId().operator->() == nullptr);
+}
+
+int main() {
+    lazyIdAfterMove();
+    destroyedId();
+    foreignId();
+    return 0;
+}
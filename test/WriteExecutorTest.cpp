@@ -0,0 +1,88 @@
+/**
+ *  WriteExecutorTest.cpp
+ *  Stress tests the WriteExecutor queue with many producer threads, checking
+ *  that no job is lost or left waiting, including around shutdown
+ *
+ *  @author William Horstkamp
+ */
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+#include "WriteExecutor.h"
+#include "Check.h"
+
+using namespace SQLiter;
+
+static const std::chrono::seconds patience(10);
+
+/**
+ *  Producers submit in small bursts with pauses, so the writer thread keeps
+ *  falling asleep and has to be woken by a racing push. A lost wakeup shows
+ *  up as a future that is not ready in time.
+ */
+static void manyProducers() {
+    SQLiteHandler db;
+    db.createDatabase();
+    db.rawExec("CREATE TABLE t(producer INTEGER, n INTEGER)");
+    const int threads = 8;
+    const int perThread = 2000;
+    {
+        WriteExecutor writer(db, 64, std::chrono::milliseconds(0));
+        std::vector<std::thread> producers;
+        for (int p = 0; p < threads; p++) {
+            producers.push_back(std::thread([&writer, p] {
+                for (int i = 0; i < perThread; i++) {
+                    std::future<int> done = writer.submit([p, i](SQLiteHandler &conn) {
+                        StatementHandler *stmt = conn.cached("INSERT INTO t VALUES(?, ?)");
+                        stmt->bindAll(p, i);
+                        stmt->step();
+                        stmt->reset();
+                        return i;
+                    });
+                    if (i % 50 == 0) {
+                        CHECK(done.wait_for(patience) == std::future_status::ready);
+                        CHECK(done.get() == i);
+                        std::this_thread::sleep_for(std::chrono::microseconds(p * 10));
+                    }
+                }
+            }));
+        }
+        for (std::thread &producer : producers)
+            producer.join();
+    }
+    StatementHandler *count = db.cached("SELECT count(*) FROM t");
+    CHECK(count->step());
+    CHECK(count->getInt(0) == threads * perThread);
+    count->reset();
+}
+
+/**
+ *  Every job submitted before the executor is destroyed has its future
+ *  resolved, whether it ran or was failed on shutdown.
+ */
+static void shutdownResolvesEveryJob() {
+    SQLiteHandler db;
+    db.createDatabase();
+    db.rawExec("CREATE TABLE t(a INTEGER)");
+    for (int round = 0; round < 50; round++) {
+        std::vector<std::future<void>> futures;
+        {
+            WriteExecutor writer(db, 16, std::chrono::milliseconds(1));
+            for (int i = 0; i < 200; i++) {
+                futures.push_back(writer.submit([](SQLiteHandler &conn) {
+                    conn.rawExec("INSERT INTO t VALUES(1)");
+                }));
+            }
+        }
+        for (std::future<void> &done : futures)
+            CHECK(done.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    }
+}
+
+int main() {
+    manyProducers();
+    shutdownResolvesEveryJob();
+    return 0;
+}